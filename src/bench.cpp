@@ -0,0 +1,86 @@
+#include "bench.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+
+// Every 10th position of positions.txt, embedded so the signature never depends on the working directory.
+static const char* const BENCH_FENS[] = {
+    "rn2kb1r/pp3ppp/4pn2/2pq4/3P2b1/2P2N2/PP2BPPP/RNBQK2R w KQkq -",
+    "2q5/4kp2/5p2/4p3/2Bp3P/2b2QP1/4PP2/6K1 w - -",
+    "r1bqk2r/pp1n1ppp/2pbpn2/3p4/2PP4/3BPN2/PP1N1PPP/R1BQK2R w KQkq -",
+    "3r2k1/p4bp1/1q5p/8/3Npp2/1PQ5/P4PPP/3R2K1 w - -",
+    "2kr1b1r/ppp3pp/8/2n2p2/4pP1q/1PN1P3/PBPP3P/R2Q1R1K w - -",
+    "5k2/5ppp/8/3p2P1/8/pP4PP/P1K5/8 w - -",
+    "r1bqkb1r/ppp1p1pp/1nnpp3/8/2PP4/5N2/PP3PPP/RNBQKB1R w KQkq -",
+    "3r2k1/p2n1ppp/2p1r1b1/3n3q/PpN1p2P/1P2P1P1/1BQ1PPB1/R3K2R w KQ -",
+    "r3kb1r/pppn1ppp/2n1p3/2P1P3/3P1q2/2N2P2/PP2BB1P/R2QK2R w KQkq -",
+    "8/p5kp/6p1/2bP1p2/P7/1r6/2NK3P/5R2 w - -",
+    "3r1r2/1pk2pp1/1pp1p1p1/8/1P1P3P/2P3P1/P1R2P2/4R1K1 w - -",
+    "3q1rk1/pb2npb1/1p1np1pp/1B1p4/1P1PP3/P3BPQP/3NN1P1/2R3K1 w - -",
+    "rb3rk1/pp1qnppp/2n5/1N1p1b2/R1PP4/1P1BBN2/5PPP/3QK2R w K -",
+    "1Q5r/5ppk/3np2p/P2p4/8/8/P3KP2/8 w - -",
+    "8/8/8/R5p1/2B3P1/p6r/2K2P2/k7 w - -",
+    "r3kb1r/pppnqpp1/3np3/7p/3P2P1/1B2PN1P/PP1B1P2/R2QK2R w KQkq -",
+    "r4rk1/ppp5/1q5p/n4bpn/4Np2/2NB1P2/PPQ2KPP/R6R w - -",
+    "rn1q1br1/ppk1p3/2ppb2p/4P1n1/3P1Q2/2P1NN2/PP3PPP/R3KB1R w KQ -",
+    "8/3rp1kp/1rp3p1/p1R1P3/P2P4/5P2/6KP/3R4 w - -",
+    "8/5bk1/5bpp/5p2/N2p1P2/3Pn3/3BP1BP/5K2 w - -",
+};
+
+BenchResult runBench(int depth, std::ostream* log, bool hwCounters) {
+    EngineConfig cfg;
+    cfg.ttSizeMB = BENCH_TT_MB;
+    cfg.useOpeningBook = false;
+    cfg.multiPV = 1;
+    Engine engine(cfg);
+
+    SearchLimits limits;
+    limits.depth = depth;   // depth only: no clock, so no time-dependent cutoffs
+
+    std::unique_ptr<PerfCounters> hw;
+    if (hwCounters) {
+        hw = std::make_unique<PerfCounters>();
+        if (!hw->available()) {
+            if (log) *log << "hardware counters unavailable: " << hw->unavailableReason() << "\n";
+            hw.reset();
+        }
+    }
+
+    BenchResult result;
+    if (hw) hw->start();
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (const char* fen : BENCH_FENS) {
+        Board board;
+        board.createBoardFromFEN(fen);
+        engine.newGame();
+
+        const Move best = engine.getMove(board, limits);
+        result.nodes += engine.lastSearchNodes();
+        result.positions++;
+
+        if (log) {
+            *log << "Position " << std::setw(2) << result.positions << ": " << moveToUCI(best)
+                 << "  nodes " << engine.lastSearchNodes() << "  " << fen << "\n";
+        }
+    }
+
+    result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (hw) result.counters = hw->stop();
+    result.nps = (uint64_t)((double)result.nodes * 1000.0 / std::max(1.0, result.ms));
+
+    if (log) {
+        *log << "===========================\n"
+             << "Total time (ms) : " << (uint64_t)result.ms << "\n"
+             << "Nodes searched  : " << result.nodes << "\n"
+             << "Nodes/second    : " << result.nps << "\n";
+        if (hw) {
+            *log << "Hardware counters (per search node):\n";
+            printPerfSample(*log, result.counters, result.nodes);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "perf_counters.h"
+
+#include <cstdint>
+#include <ostream>
+
+// Deterministic search benchmark: fixed-depth searches over a fixed position list,
+// with the engine state cleared before every position.
+// The total node count is a functional signature (any search change alters it);
+// NPS is the speed number.
+struct BenchResult {
+    uint64_t nodes = 0;
+    double   ms = 0.0;
+    uint64_t nps = 0;
+    int      positions = 0;
+    PerfSample counters;    // hardware counters over all searches (only when requested and available)
+};
+
+inline constexpr int BENCH_DEFAULT_DEPTH = 7;
+inline constexpr int BENCH_TT_MB = 16;
+
+// log (optional) receives one line per position plus the summary.
+// hwCounters wraps the searches in PerfCounters and adds a per-node report to the summary.
+BenchResult runBench(int depth = BENCH_DEFAULT_DEPTH, std::ostream* log = nullptr, bool hwCounters = false);
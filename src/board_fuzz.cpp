@@ -0,0 +1,484 @@
+#include "chess.h"
+#include "perft.h"
+#include "test_corpus.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------
+// Randomized differential test of the incremental board state.
+//
+//   board_fuzz [positions.txt] [--seed N] [--seconds N] [--plies N] [--perft-every N] [--perft-depth N]
+//
+// Plays random legal games from positions.txt + the PerftSuite FENs. At every ply it checks:
+//   - every legal move: after makeMove, zobristHash == generateZobristHash() and pieceAt matches
+//     the bitboards; after undoMove the whole state is back to what it was
+//   - the move list against a slow reference generator (plain mailbox + ray scans, shares no
+//     code with chess.cpp), and the played move against the reference position it tracks
+//   - every N plies, perft(depth) against the reference perft
+// The first failure prints the start FEN and the moves played, then exits 1.
+// ------------------------------------------------------------
+
+// ------------------------------------------------------------
+// Reference position. Same square numbering as Board (0 = h1, 7 = a1, 63 = a8)
+// and the same piece letters (white lowercase, black uppercase).
+// ------------------------------------------------------------
+struct RefPos {
+    std::array<char, 64> sq{};
+    bool white = true;
+    bool castle[4] = {};    // white king side, white queen side, black king side, black queen side
+    int ep = -1;            // square passed over by the last double push, or -1
+};
+
+struct RefMove {
+    int from, to;
+    char promo;             // lowercase or 0
+
+    bool operator<(const RefMove& o) const {
+        if (from != o.from) return from < o.from;
+        if (to != o.to) return to < o.to;
+        return promo < o.promo;
+    }
+    bool operator==(const RefMove& o) const { return from == o.from && to == o.to && promo == o.promo; }
+};
+
+static bool isWhitePiece(char c) { return c >= 'a' && c <= 'z'; }
+static bool isBlackPiece(char c) { return c >= 'A' && c <= 'Z'; }
+static bool isOwn(char c, bool white) { return white ? isWhitePiece(c) : isBlackPiece(c); }
+static bool isEnemy(char c, bool white) { return white ? isBlackPiece(c) : isWhitePiece(c); }
+static char kind(char c) { return (char)std::tolower((unsigned char)c); }
+static char colored(char lowerKind, bool white) { return white ? lowerKind : (char)std::toupper((unsigned char)lowerKind); }
+
+static bool onBoard(int r, int f) { return r >= 0 && r < 8 && f >= 0 && f < 8; }
+
+static const int KNIGHT_D[8][2] = { {1,2},{2,1},{2,-1},{1,-2},{-1,-2},{-2,-1},{-2,1},{-1,2} };
+static const int KING_D[8][2]   = { {1,0},{1,1},{0,1},{-1,1},{-1,0},{-1,-1},{0,-1},{1,-1} };
+static const int ROOK_D[4][2]   = { {1,0},{-1,0},{0,1},{0,-1} };
+static const int BISHOP_D[4][2] = { {1,1},{1,-1},{-1,1},{-1,-1} };
+
+// is `s` attacked by the side `byWhite`?
+static bool refAttacked(const RefPos& p, int s, bool byWhite) {
+    const int r = s / 8, f = s % 8;
+
+    const int pawnFromRank = byWhite ? r - 1 : r + 1;
+    for (int df : { -1, 1 }) {
+        if (onBoard(pawnFromRank, f + df) && p.sq[pawnFromRank * 8 + f + df] == colored('p', byWhite)) return true;
+    }
+    for (const auto& d : KNIGHT_D) {
+        if (onBoard(r + d[0], f + d[1]) && p.sq[(r + d[0]) * 8 + f + d[1]] == colored('n', byWhite)) return true;
+    }
+    for (const auto& d : KING_D) {
+        if (onBoard(r + d[0], f + d[1]) && p.sq[(r + d[0]) * 8 + f + d[1]] == colored('k', byWhite)) return true;
+    }
+    auto ray = [&](const int (*dirs)[2], char slider) {
+        for (int i = 0; i < 4; ++i) {
+            for (int rr = r + dirs[i][0], ff = f + dirs[i][1]; onBoard(rr, ff); rr += dirs[i][0], ff += dirs[i][1]) {
+                const char c = p.sq[rr * 8 + ff];
+                if (c == ' ') continue;
+                if (c == colored(slider, byWhite) || c == colored('q', byWhite)) return true;
+                break;
+            }
+        }
+        return false;
+    };
+    return ray(ROOK_D, 'r') || ray(BISHOP_D, 'b');
+}
+
+static void refMake(RefPos& p, const RefMove& m) {
+    const char piece = p.sq[m.from];
+    const bool white = p.white;
+
+    // en passant victim
+    if (kind(piece) == 'p' && m.to == p.ep && p.sq[m.to] == ' ') {
+        p.sq[white ? m.to - 8 : m.to + 8] = ' ';
+    }
+    // castling: move the rook too
+    if (kind(piece) == 'k' && std::abs(m.to - m.from) == 2) {
+        const bool kingSide = m.to < m.from;
+        const int rookFrom = kingSide ? m.from - 3 : m.from + 4;
+        const int rookTo   = kingSide ? m.from - 1 : m.from + 1;
+        p.sq[rookTo] = p.sq[rookFrom];
+        p.sq[rookFrom] = ' ';
+    }
+
+    p.sq[m.to] = m.promo ? colored(m.promo, white) : piece;
+    p.sq[m.from] = ' ';
+
+    p.ep = (kind(piece) == 'p' && std::abs(m.to - m.from) == 16) ? (m.from + m.to) / 2 : -1;
+
+    if (kind(piece) == 'k') {
+        p.castle[white ? 0 : 2] = false;
+        p.castle[white ? 1 : 3] = false;
+    }
+    // a rook leaving or being captured on its corner
+    for (int s : { m.from, m.to }) {
+        if (s == 0)  p.castle[0] = false;
+        if (s == 7)  p.castle[1] = false;
+        if (s == 56) p.castle[2] = false;
+        if (s == 63) p.castle[3] = false;
+    }
+
+    p.white = !white;
+}
+
+static int refKing(const RefPos& p, bool white) {
+    for (int s = 0; s < 64; ++s) {
+        if (p.sq[s] == colored('k', white)) return s;
+    }
+    return -1;
+}
+
+static void refMoves(const RefPos& p, std::vector<RefMove>& out) {
+    out.clear();
+    const bool white = p.white;
+    std::vector<RefMove> pseudo;
+
+    auto add = [&](int from, int to) { pseudo.push_back({ from, to, 0 }); };
+
+    for (int s = 0; s < 64; ++s) {
+        const char c = p.sq[s];
+        if (!isOwn(c, white)) continue;
+        const int r = s / 8, f = s % 8;
+
+        switch (kind(c)) {
+        case 'p': {
+            const int dir = white ? 1 : -1;
+            const int startRank = white ? 1 : 6;
+            const int lastRank = white ? 7 : 0;
+            auto addPawn = [&](int to) {
+                if (to / 8 == lastRank) {
+                    for (char pr : { 'q', 'r', 'b', 'n' }) pseudo.push_back({ s, to, pr });
+                }
+                else {
+                    add(s, to);
+                }
+            };
+            const int r1 = r + dir;
+            if (onBoard(r1, f) && p.sq[r1 * 8 + f] == ' ') {
+                addPawn(r1 * 8 + f);
+                const int r2 = r + 2 * dir;
+                if (r == startRank && p.sq[r2 * 8 + f] == ' ') add(s, r2 * 8 + f);
+            }
+            for (int df : { -1, 1 }) {
+                if (!onBoard(r1, f + df)) continue;
+                const int to = r1 * 8 + f + df;
+                if (isEnemy(p.sq[to], white)) addPawn(to);
+                else if (to == p.ep && p.sq[to] == ' ') add(s, to);
+            }
+            break;
+        }
+        case 'n':
+        case 'k': {
+            const auto* d = (kind(c) == 'n') ? KNIGHT_D : KING_D;
+            for (int i = 0; i < 8; ++i) {
+                const int rr = r + d[i][0], ff = f + d[i][1];
+                if (onBoard(rr, ff) && !isOwn(p.sq[rr * 8 + ff], white)) add(s, rr * 8 + ff);
+            }
+            break;
+        }
+        default: {
+            auto slide = [&](const int (*dirs)[2]) {
+                for (int i = 0; i < 4; ++i) {
+                    for (int rr = r + dirs[i][0], ff = f + dirs[i][1]; onBoard(rr, ff); rr += dirs[i][0], ff += dirs[i][1]) {
+                        const char t = p.sq[rr * 8 + ff];
+                        if (isOwn(t, white)) break;
+                        add(s, rr * 8 + ff);
+                        if (t != ' ') break;
+                    }
+                }
+            };
+            if (kind(c) == 'r' || kind(c) == 'q') slide(ROOK_D);
+            if (kind(c) == 'b' || kind(c) == 'q') slide(BISHOP_D);
+            break;
+        }
+        }
+    }
+
+    // castling: rights, empty path, rook on its corner, king not in / through / into check
+    const int k = white ? 3 : 59;
+    if (p.sq[k] == colored('k', white) && !refAttacked(p, k, !white)) {
+        const char rook = colored('r', white);
+        if (p.castle[white ? 0 : 2] && p.sq[k - 3] == rook && p.sq[k - 1] == ' ' && p.sq[k - 2] == ' ' &&
+            !refAttacked(p, k - 1, !white) && !refAttacked(p, k - 2, !white)) {
+            add(k, k - 2);
+        }
+        if (p.castle[white ? 1 : 3] && p.sq[k + 4] == rook && p.sq[k + 1] == ' ' && p.sq[k + 2] == ' ' && p.sq[k + 3] == ' ' &&
+            !refAttacked(p, k + 1, !white) && !refAttacked(p, k + 2, !white)) {
+            add(k, k + 2);
+        }
+    }
+
+    for (const RefMove& m : pseudo) {
+        RefPos q = p;
+        refMake(q, m);
+        const int king = refKing(q, white);
+        if (king >= 0 && !refAttacked(q, king, !white)) out.push_back(m);
+    }
+}
+
+static uint64_t refPerft(const RefPos& p, int depth) {
+    if (depth == 0) return 1;
+    std::vector<RefMove> moves;
+    refMoves(p, moves);
+    if (depth == 1) return moves.size();
+
+    uint64_t n = 0;
+    for (const RefMove& m : moves) {
+        RefPos q = p;
+        refMake(q, m);
+        n += refPerft(q, depth - 1);
+    }
+    return n;
+}
+
+// Reference position read from the Board's bitboards (not its mailbox) and flags.
+static RefPos refFromBoard(const Board& b) {
+    RefPos p;
+    p.sq.fill(' ');
+    const std::pair<Bitboard, char> sets[] = {
+        { b.whitePawns, 'p' }, { b.whiteKnights, 'n' }, { b.whiteBishops, 'b' },
+        { b.whiteRooks, 'r' }, { b.whiteQueens, 'q' }, { b.whiteKing, 'k' },
+        { b.blackPawns, 'P' }, { b.blackKnights, 'N' }, { b.blackBishops, 'B' },
+        { b.blackRooks, 'R' }, { b.blackQueens, 'Q' }, { b.blackKing, 'K' },
+    };
+    for (const auto& [bb, c] : sets) {
+        for (int s = 0; s < 64; ++s) {
+            if ((bb >> s) & 1) p.sq[s] = c;
+        }
+    }
+    p.white = b.whiteToMove;
+    p.castle[0] = !b.whiteKingMoved && !b.whiteRRookMoved;
+    p.castle[1] = !b.whiteKingMoved && !b.whiteLRookMoved;
+    p.castle[2] = !b.blackKingMoved && !b.blackRRookMoved;
+    p.castle[3] = !b.blackKingMoved && !b.blackLRookMoved;
+    p.ep = b.enPassantTarget ? std::countr_zero(b.enPassantTarget) : -1;
+    return p;
+}
+
+// ------------------------------------------------------------
+// Board consistency checks
+// ------------------------------------------------------------
+
+// bitboards are disjoint, the colour unions match, and the mailbox agrees with them
+static bool checkBoard(const Board& b, std::string& why) {
+    const Bitboard white[6] = { b.whitePawns, b.whiteKnights, b.whiteBishops, b.whiteRooks, b.whiteQueens, b.whiteKing };
+    const Bitboard black[6] = { b.blackPawns, b.blackKnights, b.blackBishops, b.blackRooks, b.blackQueens, b.blackKing };
+
+    Bitboard seen = 0, w = 0, bl = 0;
+    for (int i = 0; i < 6; ++i) {
+        if ((seen & white[i]) || (seen & black[i]) || (white[i] & black[i])) { why = "overlapping piece bitboards"; return false; }
+        seen |= white[i] | black[i];
+        w |= white[i];
+        bl |= black[i];
+    }
+    if (w != b.whitePieces) { why = "whitePieces != union of white bitboards"; return false; }
+    if (bl != b.blackPieces) { why = "blackPieces != union of black bitboards"; return false; }
+    if (std::popcount(b.whiteKing) != 1 || std::popcount(b.blackKing) != 1) { why = "king count"; return false; }
+
+    const RefPos fromBits = refFromBoard(b);
+    for (int s = 0; s < 64; ++s) {
+        if (b.pieceAt[s] != fromBits.sq[s]) {
+            why = "mailbox '" + std::string(1, b.pieceAt[s]) + "' vs bitboards '" + std::string(1, fromBits.sq[s]) +
+                  "' on " + numToBoardPosition(s);
+            return false;
+        }
+    }
+
+    if (b.zobristHash != b.generateZobristHash()) { why = "incremental zobristHash != generateZobristHash()"; return false; }
+    return true;
+}
+
+// everything makeMove/undoMove are responsible for
+static bool sameState(const Board& a, const Board& b) {
+    return a.whitePawns == b.whitePawns && a.blackPawns == b.blackPawns &&
+           a.whiteKnights == b.whiteKnights && a.blackKnights == b.blackKnights &&
+           a.whiteBishops == b.whiteBishops && a.blackBishops == b.blackBishops &&
+           a.whiteRooks == b.whiteRooks && a.blackRooks == b.blackRooks &&
+           a.whiteQueens == b.whiteQueens && a.blackQueens == b.blackQueens &&
+           a.whiteKing == b.whiteKing && a.blackKing == b.blackKing &&
+           a.whitePieces == b.whitePieces && a.blackPieces == b.blackPieces &&
+           a.enPassantTarget == b.enPassantTarget && a.epFile == b.epFile &&
+           a.whiteToMove == b.whiteToMove &&
+           a.whiteKingMoved == b.whiteKingMoved && a.whiteLRookMoved == b.whiteLRookMoved &&
+           a.whiteRRookMoved == b.whiteRRookMoved && a.blackKingMoved == b.blackKingMoved &&
+           a.blackLRookMoved == b.blackLRookMoved && a.blackRRookMoved == b.blackRRookMoved &&
+           a.zobristHash == b.zobristHash && a.pieceAt == b.pieceAt &&
+           a.repPly == b.repPly && a.repIrrevIndex == b.repIrrevIndex;
+}
+
+static bool samePosition(const RefPos& a, const RefPos& b, std::string& why) {
+    if (a.sq != b.sq) { why = "pieces differ from the reference position"; return false; }
+    if (a.white != b.white) { why = "side to move differs from the reference"; return false; }
+    for (int i = 0; i < 4; ++i) {
+        if (a.castle[i] != b.castle[i]) { why = "castling right " + std::to_string(i) + " differs from the reference"; return false; }
+    }
+    if (a.ep != b.ep) { why = "en passant square differs from the reference"; return false; }
+    return true;
+}
+
+static std::vector<RefMove> toRef(const MoveList& ml) {
+    std::vector<RefMove> out;
+    for (const Move& m : ml) out.push_back({ m.from, m.to, m.promotion ? kind(m.promotion) : (char)0 });
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+static std::string refMoveToUCI(const RefMove& m) {
+    std::string s = numToBoardPosition(m.from) + numToBoardPosition(m.to);
+    if (m.promo) s += m.promo;
+    return s;
+}
+
+// ------------------------------------------------------------
+// Driver
+// ------------------------------------------------------------
+struct FuzzStats {
+    uint64_t games = 0;
+    uint64_t plies = 0;          // moves played
+    uint64_t makeUndo = 0;       // make/undo pairs verified
+    uint64_t perftChecks = 0;
+};
+
+struct Failure {
+    std::string fen;
+    std::vector<std::string> moves;
+    std::string what;
+};
+
+static bool playGame(const std::string& fen, std::mt19937_64& rng, int maxPlies, int perftEvery, int perftDepth,
+                     FuzzStats& st, Failure& fail) {
+    Board board;
+    board.createBoardFromFEN(fen);
+    RefPos ref = refFromBoard(board);
+
+    fail.fen = fen;
+    fail.moves.clear();
+
+    auto bad = [&](const std::string& what) { fail.what = what; return false; };
+
+    std::string why;
+    if (!checkBoard(board, why)) return bad("after loading the FEN: " + why);
+
+    for (int ply = 0; ply < maxPlies; ++ply) {
+        MoveList legal;
+        board.generateAllMoves(legal);
+
+        std::vector<RefMove> expected;
+        refMoves(ref, expected);
+        std::sort(expected.begin(), expected.end());
+        const std::vector<RefMove> got = toRef(legal);
+        if (got != expected) {
+            std::string diff;
+            for (const RefMove& m : expected) if (!std::binary_search(got.begin(), got.end(), m)) diff += " missing " + refMoveToUCI(m);
+            for (const RefMove& m : got) if (!std::binary_search(expected.begin(), expected.end(), m)) diff += " extra " + refMoveToUCI(m);
+            if (std::adjacent_find(got.begin(), got.end()) != got.end()) diff += " (duplicates)";
+            return bad("generateAllMoves differs from the reference:" + diff);
+        }
+
+        // every legal move: make, check, undo, check that nothing leaked
+        const Board before = board;
+        for (int i = 0; i < legal.size; ++i) {
+            Move m = legal.m[i];
+            Undo u;
+            board.makeMove(m, u);
+            if (!checkBoard(board, why)) {
+                fail.moves.push_back(moveToUCI(m));
+                return bad("after makeMove: " + why);
+            }
+            board.undoMove(m, u);
+            if (!sameState(board, before)) return bad("undoMove " + moveToUCI(m) + " did not restore the position");
+            st.makeUndo++;
+        }
+
+        if (perftEvery > 0 && ply % perftEvery == 0) {
+            Board copy = board;
+            const uint64_t a = perftNodes(copy, perftDepth);
+            const uint64_t b = refPerft(ref, perftDepth);
+            st.perftChecks++;
+            if (a != b) return bad("perft " + std::to_string(perftDepth) + " = " + std::to_string(a) + ", reference " + std::to_string(b));
+        }
+
+        if (legal.size == 0) break;
+
+        Move m = legal.m[std::uniform_int_distribution<int>(0, legal.size - 1)(rng)];
+        Undo u;
+        board.makeMove(m, u);
+        refMake(ref, { m.from, m.to, m.promotion ? kind(m.promotion) : (char)0 });
+        fail.moves.push_back(moveToUCI(m));
+        st.plies++;
+
+        if (!samePosition(refFromBoard(board), ref, why)) return bad("after playing the move: " + why);
+
+        if (board.repPly >= Board::MAX_REP_PLY - 2) break;
+    }
+
+    st.games++;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string positionsPath = "positions.txt";
+    uint64_t seed = std::random_device{}();
+    double seconds = 60.0;
+    int maxPlies = 300;
+    int perftEvery = 16;
+    int perftDepth = 2;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--seed" && i + 1 < argc)             seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--seconds" && i + 1 < argc)     seconds = std::atof(argv[++i]);
+        else if (a == "--plies" && i + 1 < argc)       maxPlies = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--perft-every" && i + 1 < argc) perftEvery = std::max(0, std::atoi(argv[++i]));
+        else if (a == "--perft-depth" && i + 1 < argc) perftDepth = std::clamp(std::atoi(argv[++i]), 1, 4);
+        else positionsPath = a;
+    }
+
+    const std::vector<std::string> fens = loadTestCorpus(positionsPath);
+    std::mt19937_64 rng(seed);
+
+    std::cout << "board_fuzz: " << fens.size() << " start positions, seed " << seed << ", "
+              << seconds << " s, up to " << maxPlies << " plies per game\n";
+
+    FuzzStats st;
+    Failure fail;
+    const auto t0 = std::chrono::steady_clock::now();
+    auto elapsed = [&] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count(); };
+
+    double nextReport = 10.0;
+    while (elapsed() < seconds) {
+        const std::string& fen = fens[std::uniform_int_distribution<size_t>(0, fens.size() - 1)(rng)];
+        if (!playGame(fen, rng, maxPlies, perftEvery, perftDepth, st, fail)) {
+            std::cout << "\nFAIL: " << fail.what << "\n"
+                      << "  position fen " << fail.fen;
+            if (!fail.moves.empty()) {
+                std::cout << " moves";
+                for (const std::string& m : fail.moves) std::cout << " " << m;
+            }
+            std::cout << "\n  (seed " << seed << ")\n";
+            return 1;
+        }
+        if (elapsed() >= nextReport) {
+            std::cout << "  " << (int)elapsed() << " s: " << st.games << " games, " << st.plies << " plies\n";
+            nextReport += 10.0;
+        }
+    }
+
+    const double s = std::max(elapsed(), 1e-9);
+    std::cout << "OK: " << st.games << " games, " << st.plies << " plies played ("
+              << (uint64_t)(st.plies * 60.0 / s) << " per minute), "
+              << st.makeUndo << " make/undo pairs verified ("
+              << (uint64_t)(st.makeUndo * 60.0 / s) << " per minute), "
+              << st.perftChecks << " perft comparisons\n";
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "chess.h"
+#include "probes.h"
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -132,11 +133,8 @@ static void init_attack_tables() {
 }
 
 static inline void init_attack_tables_once() {
-    static bool inited = false;
-    if (!inited) {
-        init_attack_tables();
-        inited = true;
-    }
+    static const bool inited = (init_attack_tables(), true); // thread-safe one-time init
+    (void)inited;
 }
 
 static inline int first_blocker_sq(Bitboard blockers, int dirDelta) {
@@ -180,6 +178,9 @@ static inline __forceinline Bitboard bishop_attacks(int sq, Bitboard occ) {
     return BISHOP_TAB[sq][idx];
 }
 
+Bitboard rookAttacks(int sq, Bitboard occ)   { return rook_attacks(sq, occ); }
+Bitboard bishopAttacks(int sq, Bitboard occ) { return bishop_attacks(sq, occ); }
+
 static inline Bitboard rook_attacks_slow(int from, Bitboard occ) {
     Bitboard a = 0;
     const int dirs[4] = { DIR_N, DIR_S, DIR_E, DIR_W };
@@ -357,11 +358,8 @@ static inline bool isSquareAttacked(int targetSquare, bool attackersAreWhite, Bi
 }
 
 static inline void init_slider_pext_tables_once() {
-    static bool done = false;
-    if (!done) {
-        init_slider_pext_tables();
-        done = true;
-    }
+    static const bool done = (init_slider_pext_tables(), true); // thread-safe one-time init
+    (void)done;
 }
 
 Bitboard Board::computePinnedMask(bool forWhite) const {
@@ -958,6 +956,7 @@ void Board::generateQueenMoves(MoveList& moves, Bitboard queens, Bitboard ownPie
 }
 
 void Board::generateAllMoves(MoveList& legalMoves) {
+    ENGINE_PROBE(PROBE_MOVEGEN);
     legalMoves.clear();
 
     Bitboard ownPieces = whiteToMove ? whitePieces : blackPieces;
@@ -1013,6 +1012,7 @@ void Board::generateAllMoves(MoveList& legalMoves) {
 }
 
 bool Board::amIInCheck(bool player) {
+    ENGINE_PROBE(PROBE_CHECK_TEST);
     const Bitboard ownKing = player ? whiteKing : blackKing;
     const int kingPos = lsb_index(ownKing);
 
@@ -1086,6 +1086,7 @@ void Board::undoNullMove(const Undo& u) {
 }
 
 void Board::makeMove(Move& move, Undo& u) {
+    ENGINE_PROBE(PROBE_MAKE_MOVE);
     // ---- store undo state ----
     u.prevHash = zobristHash;
 
@@ -1464,6 +1465,7 @@ void Board::makeMove(Move& move, Undo& u) {
 }
 
 void Board::undoMove(const Move& move, const Undo& u) {
+    ENGINE_PROBE(PROBE_UNDO_MOVE);
     enPassantTarget = u.prevEnPassantTarget;
     epFile = u.prevEpFile;
 
@@ -1986,6 +1988,65 @@ Move convertToMoveObject(const std::string& moveStr) {
     return m;
 }
 
+std::string moveToUCI(const Move& move) {
+    if (move == NO_MOVE) return "0000";
+
+    std::string s = numToBoardPosition(move.from) + numToBoardPosition(move.to);
+    if (move.promotion) {
+        char p = move.promotion;
+        if (p >= 'A' && p <= 'Z') p = char(p - 'A' + 'a');
+        s.push_back(p);
+    }
+    return s;
+}
+
+// Decode without generating the full move list: only the moving piece's moves are generated,
+// then the single candidate is legality-checked by make/undo.
+bool parseUCIMove(Board& board, const std::string& uci, Move& out) {
+    const Move wanted = convertToMoveObject(uci);
+    if (wanted == NO_MOVE) return false;
+
+    char pc = board.pieceAt[wanted.from];
+    if (pc == ' ') return false;
+
+    const bool pieceIsWhite = (pc >= 'a' && pc <= 'z');
+    if (pieceIsWhite != board.whiteToMove) return false;
+    if (!pieceIsWhite) pc = char(pc - 'A' + 'a');
+
+    const Bitboard ownPieces      = board.whiteToMove ? board.whitePieces : board.blackPieces;
+    const Bitboard opponentPieces = board.whiteToMove ? board.blackPieces : board.whitePieces;
+    const Bitboard fromMask = 1ULL << wanted.from;
+
+    MoveList pseudo;
+    switch (pc) {
+        case 'p': board.generatePawnMoves(pseudo, fromMask, ownPieces, opponentPieces); break;
+        case 'n': board.generateKnightMoves(pseudo, fromMask, ownPieces, opponentPieces); break;
+        case 'b': board.generateBishopMoves(pseudo, fromMask, ownPieces, opponentPieces); break;
+        case 'r': board.generateRookMoves(pseudo, fromMask, ownPieces, opponentPieces); break;
+        case 'q': board.generateQueenMoves(pseudo, fromMask, ownPieces, opponentPieces); break;
+        case 'k': board.generateKingMoves(pseudo, fromMask, ownPieces, opponentPieces); break;
+        default: return false;
+    }
+
+    for (int i = 0; i < pseudo.size; ++i) {
+        Move mv = pseudo.m[i];
+        if (mv != wanted) continue;
+
+        // king moves are generated legal (attacked squares and castling paths are checked)
+        if (pc == 'k') { out = mv; return true; }
+
+        Undo u;
+        board.makeMove(mv, u);
+        const bool legal = !board.amIInCheck(!board.whiteToMove);
+        board.undoMove(mv, u);
+
+        if (!legal) return false;
+        out = mv;
+        return true;
+    }
+    return false;
+}
+
 int clamp(int value, int max, int min) {
     if (value > max) return max;
     if (value < min) return min;
@@ -197,11 +197,17 @@ std::string numToBoardPosition(int num);
 bool isTacticalPosition(const std::vector<Move>& moves, const Board& board);
 bool isNullViable(Board& board);
 Move convertToMoveObject(const std::string& moveStr);
+std::string moveToUCI(const Move& move);
+bool parseUCIMove(Board& board, const std::string& uci, Move& out); // decode + legality check of one move
 int boardPositionToIndex(const std::string& pos);
 int isGoodCapture(const Move& move, const Board& board);
 bool isEqualCapture(const Move& move, const Board& board);
 int getPieceValue(char piece);
 
+// Slider attack lookups (PEXT tables); tables are built by the first Board()
+Bitboard rookAttacks(int sq, Bitboard occ);
+Bitboard bishopAttacks(int sq, Bitboard occ);
+
 class MovePicker {
 public:
     MovePicker(Board& b, const std::vector<Move>& moves, TT_Entry* ttEntry, int depth)
@@ -1,14 +1,15 @@
 // ========================= engine.cpp =========================
 #include "engine.h"
 #include "opening_book.h"
+#include "probes.h"
 
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <bit>
+#include <unordered_set>
 
-static constexpr int MATE_SCORE = 20000;
-static constexpr int MATE_THRESHOLD = 19000; // anything beyond this is treated as mate
+static constexpr int NO_EVAL = -1000000;      // stack_ marker for "in check, no static eval"
 
 static inline int scoreToTT(int score, int ply) {
     if (score >  MATE_THRESHOLD) return score + ply; // store as "mate score" independent of ply
@@ -22,6 +23,13 @@ static inline int scoreFromTT(int score, int ply) {
     return score;
 }
 
+// Salt for searches that exclude a move, so they never share TT entries with the full node
+static inline uint64_t exclusionKey(const Move& m) {
+    if (m == NO_MOVE) return 0;
+    const uint64_t id = (uint64_t)(m.from * 64 + m.to) * 8 + (uint64_t)(unsigned char)m.promotion;
+    return (id + 1) * 0x9E3779B97F4A7C15ULL;
+}
+
 bool isEndgameDraw(int numWhiteBishops, int numWhiteKnights, int numBlackKnights, int numBlackBishops) {
     int totalWhite = numWhiteKnights + numWhiteBishops;
     int totalBlack = numBlackKnights + numBlackBishops;
@@ -53,6 +61,20 @@ Engine::Engine(const EngineConfig& cfg)
     newGame();
 }
 
+Engine::~Engine() {
+    stop();
+    wait();
+}
+
+void Engine::setOpeningBook(std::shared_ptr<const OpeningBook> book) {
+    book_ = std::move(book);
+}
+
+void Engine::setHashSize(uint64_t mb) {
+    cfg_.ttSizeMB = mb;
+    resizeTT(mb);
+}
+
 void Engine::resizeTT(uint64_t mb) {
     // power-of-two entries, similar to your Board::resize_tt
     size_t entries = (size_t)((mb * 1048576ull) / sizeof(EngineTTEntry));
@@ -66,11 +88,13 @@ void Engine::resizeTT(uint64_t mb) {
 }
 
 Engine::EngineTTEntry* Engine::probeTT(uint64_t key) {
+    ENGINE_PROBE(PROBE_TT_PROBE);
     if (tt_.empty()) return nullptr;
     return &tt_[key & ttMask_];
 }
 
 void Engine::storeTT(uint64_t key, int score, TTFlag flag, const Move& move, int depth) {
+    ENGINE_PROBE(PROBE_TT_STORE);
     if (tt_.empty()) return;
     EngineTTEntry& e = tt_[key & ttMask_];
 
@@ -81,6 +105,7 @@ void Engine::storeTT(uint64_t key, int score, TTFlag flag, const Move& move, int
         e.flag = flag;
         e.move = move;
         e.depth = depth;
+        e.gen = ttGen_;
     }
 }
 
@@ -96,13 +121,25 @@ void Engine::newGame() {
     }
 
     for (int p = 0; p < 12; ++p) {
-        for (int sq = 0; sq < 64; ++sq) history_[p][sq] = 0;
+        for (int sq = 0; sq < 64; ++sq) {
+            history_[p][sq] = 0;
+            counterMoves_[p][sq] = NO_MOVE;
+        }
     }
-    maxHistoryValue_ = 1 << 16;
+    contHist_.assign(12 * 64, PieceToHistory{});
+    pv_.assign(MAX_PLY + 2, PVLine{});
+    std::fill(&captureHistory_[0][0][0], &captureHistory_[0][0][0] + 12 * 64 * 6, (int16_t)0);
+
+    for (int ply = 0; ply <= MAX_PLY; ++ply) {
+        stack_[ply] = SearchStackEntry{};
+        stack_[ply].staticEval = NO_EVAL;
+    }
+
+    initReductions();
 }
 
 bool Engine::outOfTime() const {
-    return std::chrono::high_resolution_clock::now() > endTime_;
+    return stop_.load(std::memory_order_relaxed);
 }
 
 bool Engine::isKiller(const Move& m, int depth) const {
@@ -120,27 +157,61 @@ void Engine::recordKiller(const Move& m, int depth) {
     }
 }
 
+// Gravity update: moves entries toward +/-HISTORY_MAX and self-limits, so no table rescaling is needed
+template <typename T>
+static inline void applyGravity(T& entry, int bonus, int maxValue) {
+    const int b = std::clamp(bonus, -maxValue, maxValue);
+    const int e = (int)entry;
+    entry = (T)(e + b - e * std::abs(b) / maxValue);
+}
+
+// Bonus for the move that caused a cutoff (and malus for quiets tried before it)
+static inline int historyBonus(int depth) {
+    return std::min(16 * depth * depth + 32 * depth + 16, 1200);
+}
+
 void Engine::updateHistory(Board& board, int from, int to, int bonus) {
     if (to < 0 || to >= 64) return;
 
     int idx = board.posToValue(from);
     if (idx < 0 || idx >= 12) return;
 
-    int64_t v = (int64_t)history_[idx][to] + (int64_t)bonus;
-    if (v < 0) v = 0;
-    if (v > maxHistoryValue_) v = maxHistoryValue_;
-    history_[idx][to] = (int32_t)v;
+    applyGravity(history_[idx][to], bonus, HISTORY_MAX);
+}
 
+void Engine::updateQuietHeuristics(Board& board, int ply, const Move& m, int bonus) {
+    updateHistory(board, m.from, m.to, bonus);
 
-    // updateHistory scaling behavior
-    if (history_[idx][to] >= maxHistoryValue_) {
-        maxHistoryValue_ <<= 1;
-        for (int i = 0; i < 12; ++i) {
-            for (int j = 0; j < 64; ++j) {
-                history_[i][j] >>= 1;
-            }
+    const int piece = board.posToValue(m.from);
+    if (piece < 0 || piece >= 12 || m.to < 0 || m.to >= 64) return;
+
+    if (ply >= 1 && stack_[ply - 1].contHist) applyGravity(stack_[ply - 1].contHist->v[piece][m.to], bonus, HISTORY_MAX);
+    if (ply >= 2 && stack_[ply - 2].contHist) applyGravity(stack_[ply - 2].contHist->v[piece][m.to], bonus, HISTORY_MAX);
+}
+
+void Engine::updateCaptureHistory(Board& board, const Move& m, int bonus) {
+    if (!m.isCapture || m.to < 0 || m.to >= 64) return;
+
+    const int piece = board.posToValue(m.from);
+    if (piece < 0 || piece >= 12) return;
+
+    applyGravity(captureHistory_[piece][m.to][capturedPieceType(m, board)], bonus, HISTORY_MAX);
+}
+
+void Engine::initReductions() {
+    // log*log reduction table; base/divisor are in hundredths so they stay int-tunable
+    const double base = cfg_.lmrBase / 100.0;
+    const double div  = std::max(1, cfg_.lmrDivisor) / 100.0;
+
+    for (int d = 0; d < LMR_DEPTHS; ++d) {
+        for (int m = 0; m < LMR_MOVES; ++m) {
+            if (d == 0 || m == 0) { lmrTable_[d][m] = 0; continue; }
+            const double r = base + std::log((double)d) * std::log((double)(m + 1)) / div;
+            lmrTable_[d][m] = std::max(0, (int)r);
         }
     }
+    lmrTableBase_ = cfg_.lmrBase;
+    lmrTableDivisor_ = cfg_.lmrDivisor;
 }
 
 void Engine::orderMoves(Board& board, MoveList& moves, const Move& hashMove, int depth) {
@@ -157,18 +228,18 @@ void Engine::orderMoves(Board& board, MoveList& moves, const Move& hashMove, int
         int score = 0;
 
         if (m == hashMove) {
-            score = (int)maxHistoryValue_ + 100;
+            score = HISTORY_MAX * 4 + 100;
         }
         else if (m.isCapture || m.promotion) {
             int cap = isGoodCapture(m, board);
             score += cap;
 
             if (m.promotion) score += getPieceValue(m.promotion) + 1000; // promo bias
-            if (cap >= 0 || m.promotion) score += (int)maxHistoryValue_ + 1;
+            if (cap >= 0 || m.promotion) score += HISTORY_MAX * 4 + 1;
             // else: keep negative captures low
         }
         else if (isKiller(m, depth)) {
-            score = (int)maxHistoryValue_;
+            score = HISTORY_MAX * 4;
         }
         else {
             int idx = board.posToValue(m.from);
@@ -188,6 +259,7 @@ void Engine::orderMoves(Board& board, MoveList& moves, const Move& hashMove, int
 }
 
 int Engine::evaluate(Board& board) const {
+    ENGINE_PROBE(PROBE_EVALUATE);
     // quick draw: kings only
     if ((std::popcount(board.whitePieces) == 1) && (std::popcount(board.blackPieces) == 1)) return 0;
     
@@ -551,12 +623,13 @@ int Engine::evaluate(Board& board) const {
 }
 
 int Engine::quiescence(Board& board, int alpha, int beta, int ply, bool& timedOut) {
-    // node accounting first so time masking works consistently
+    ENGINE_PROBE(PROBE_QUIESCENCE);
     lastNodes_++;
+    countStat(&SearchStats::qNodes);
+    if (ply > selDepth_) selDepth_ = ply;
 
-    if (((uint32_t)lastNodes_ & cfg_.timeCheckMask) == 0u) {
-        if (outOfTime()) { timedOut = true; return 0; }
-    }
+    if (nodeLimit_ && lastNodes_ >= nodeLimit_) stop_.store(true, std::memory_order_relaxed);
+    if (outOfTime()) { timedOut = true; return 0; }
 
     // Mate distance pruning window clamp (fail-soft friendly)
     alpha = std::max(alpha, -MATE_SCORE + ply);
@@ -595,9 +668,8 @@ int Engine::quiescence(Board& board, int alpha, int beta, int ply, bool& timedOu
             if (!mv.isCapture && !mv.promotion) continue;
         }
 
-        int s = 0;
-        if (mv.promotion) s += getPieceValue(mv.promotion) + 1000;
-        if (mv.isCapture) s += isGoodCapture(mv, board);
+        int s = captureOrderScore(mv, board, captureHistory_);
+        if (mv.promotion) s += (getPieceValue(mv.promotion) + 1000) * CAPTURE_MVV_SCALE;
         cand[n++] = { mv, s };
     }
 
@@ -631,12 +703,15 @@ int Engine::quiescence(Board& board, int alpha, int beta, int ply, bool& timedOu
     return alpha;
 }
 
-int Engine::search(Board& board, int depth, int alpha, int beta, int startDepth, int ply, int totalExtensions, bool lastIterationNull, Move& bestMoveOut, bool& timedOut){
+int Engine::search(Board& board, int depth, int alpha, int beta, int startDepth, int ply, int totalExtensions, bool lastIterationNull, Move& bestMoveOut, bool& timedOut, bool cutNode, const Move& excludedMove){
+    ENGINE_PROBE(PROBE_SEARCH);
+    pv_[ply].length = 0;
     lastNodes_++;
+    countStat(&SearchStats::mainNodes);
+    if (ply > selDepth_) selDepth_ = ply;
 
-    if (((uint32_t)lastNodes_ & cfg_.timeCheckMask) == 0u) {
-        if (outOfTime()) { timedOut = true; bestMoveOut = NO_MOVE; return 0; }
-    }
+    if (nodeLimit_ && lastNodes_ >= nodeLimit_) stop_.store(true, std::memory_order_relaxed);
+    if (outOfTime()) { timedOut = true; bestMoveOut = NO_MOVE; return 0; }
 
     // Mate distance pruning window clamp
     alpha = std::max(alpha, -MATE_SCORE + ply);
@@ -657,24 +732,37 @@ int Engine::search(Board& board, int depth, int alpha, int beta, int startDepth,
     const int originalBeta  = beta;
     bestMoveOut = NO_MOVE;
 
-    const uint64_t key = board.zobristHash;
+    const bool excluding = !(excludedMove == NO_MOVE);
+    const uint64_t key = board.zobristHash ^ exclusionKey(excludedMove);
 
-    // TT probe
+    // TT probe (entries are copied out: the slot may be overwritten by child searches)
     EngineTTEntry* tt = probeTT(key);
     Move hashMove = NO_MOVE;
+    bool ttHit = false;
+    int ttScore = 0;
+    int ttDepth = -1;
+    TTFlag ttFlag = HASH_FLAG_UPPER;
 
+    if (tt) countStat(&SearchStats::ttProbes);
     if (tt && tt->key == key) {
+        countStat(&SearchStats::ttHits);
         hashMove = tt->move;
-        const int ttScore = scoreFromTT(tt->score, ply);
+        ttHit = true;
+        ttScore = scoreFromTT(tt->score, ply);
+        ttDepth = tt->depth;
+        ttFlag = tt->flag;
 
-        if (tt->depth >= depth) {
+        // never cut at the root: it must always produce a move and a PV
+        if (ply > 0 && tt->depth >= depth) {
             if (tt->flag == HASH_FLAG_EXACT) {
+                countStat(&SearchStats::ttCutoffs);
                 bestMoveOut = tt->move;
                 return ttScore;
             }
             if (tt->flag == HASH_FLAG_LOWER) alpha = std::max(alpha, ttScore);
             if (tt->flag == HASH_FLAG_UPPER) beta  = std::min(beta,  ttScore);
             if (alpha >= beta) {
+                countStat(&SearchStats::ttCutoffs);
                 bestMoveOut = tt->move;
                 return ttScore;
             }
@@ -682,10 +770,24 @@ int Engine::search(Board& board, int depth, int alpha, int beta, int startDepth,
     }
 
     const bool inCheck = board.amIInCheck(board.whiteToMove);
+    const bool pvNode  = (originalBeta - originalAlpha) > 1;
+
+    // Static eval per ply; "improving" = better than our own eval two plies ago.
+    // Only LMR reads it, so nodes too shallow to reduce skip the evaluate() call. A singular
+    // verification search is the same position at the same ply: keep the outer node's eval.
+    const int staticEval = excluding ? stack_[ply].staticEval
+                         : (inCheck || depth < cfg_.lmrMinDepth) ? NO_EVAL : evaluate(board);
+    stack_[ply].staticEval = staticEval;
+    const bool improving = !inCheck && ply >= 2 &&
+                           stack_[ply - 2].staticEval != NO_EVAL && staticEval > stack_[ply - 2].staticEval;
 
     // Null-move pruning
-    if (!inCheck && !lastIterationNull && depth >= 3 && std::abs(beta) < (MATE_THRESHOLD - 500) && isNullViable(board)){
+    if (!inCheck && !excluding && !lastIterationNull && depth >= 3 && std::abs(beta) < (MATE_THRESHOLD - 500) && isNullViable(board)){
+        countStat(&SearchStats::nullTries);
         Undo nu;
+        stack_[ply].move = NO_MOVE;
+        stack_[ply].piece = -1;
+        stack_[ply].contHist = nullptr;
         board.makeNullMove(nu);
 
         Move dummy = NO_MOVE;
@@ -701,19 +803,39 @@ int Engine::search(Board& board, int depth, int alpha, int beta, int startDepth,
                             totalExtensions,
                             true,
                             dummy,
-                            timedOut);
+                            timedOut,
+                            !cutNode);
 
         board.undoNullMove(nu);
 
         if (timedOut) { bestMoveOut = NO_MOVE; return 0; }
 
         if (score >= beta) {
+            countStat(&SearchStats::nullCutoffs);
             // FAIL-SOFT: return the real score so PVS can detect improvement correctly
             bestMoveOut = NO_MOVE;
             return score;
         }
     }
 
+    // No hash move: optionally run a reduced search to seed one (IID), otherwise reduce (IIR)
+    if (!excluding && hashMove == NO_MOVE) {
+        // not at the root: re-entering search() at ply 0 would rescore and reorder rootMoves_ mid-iteration
+        if (cfg_.useIID && ply > 0 && (pvNode || cutNode) && depth >= cfg_.iidMinDepth) {
+            Move iidBest = NO_MOVE;
+            search(board, depth - cfg_.iidReduction, alpha, beta, startDepth, ply, totalExtensions,
+                   lastIterationNull, iidBest, timedOut, cutNode);
+            if (timedOut) { bestMoveOut = NO_MOVE; return 0; }
+
+            EngineTTEntry* e = probeTT(key);
+            if (e && e->key == key) hashMove = e->move;
+        }
+
+        if (cfg_.useIIR && hashMove == NO_MOVE && (pvNode || cutNode) && depth >= cfg_.iirMinDepth) {
+            depth--;
+        }
+    }
+
     MoveList moves;
     board.generateAllMoves(moves);
 
@@ -724,9 +846,11 @@ int Engine::search(Board& board, int depth, int alpha, int beta, int startDepth,
             : ((board.whiteToMove == rootSideIsWhite_) ? -cfg_.drawPenalty : cfg_.drawPenalty);
     }
 
-    // Quiet tried list
+    // Quiet / capture tried lists (for history malus on cutoff)
     Move quietTried[64];
     int quietTriedN = 0;
+    Move captureTried[32];
+    int captureTriedN = 0;
 
     int bestScore = -1000000;
 
@@ -735,68 +859,128 @@ int Engine::search(Board& board, int depth, int alpha, int beta, int startDepth,
         return evaluate(board);
     }
 
-    EngineMovePicker picker(board, moves, hashMove, killers_[0][ply], killers_[1][ply], true, history_);
+    // Singular extension candidate: TT move backed by a deep enough lower bound
+    const bool singularCandidate =
+        ply > 0 && !excluding && depth >= cfg_.singularMinDepth &&
+        ttHit && !(hashMove == NO_MOVE) &&
+        (ttFlag == HASH_FLAG_LOWER || ttFlag == HASH_FLAG_EXACT) &&
+        ttDepth >= depth - 3 && std::abs(ttScore) < (MATE_THRESHOLD - 500);
+
+    // Move context from the search stack
+    const PieceToHistory* contHist1 = (ply >= 1) ? stack_[ply - 1].contHist : nullptr;
+    const PieceToHistory* contHist2 = (ply >= 2) ? stack_[ply - 2].contHist : nullptr;
+    Move counterMove = NO_MOVE;
+    if (ply >= 1 && stack_[ply - 1].piece >= 0) {
+        counterMove = counterMoves_[stack_[ply - 1].piece][stack_[ply - 1].move.to];
+    }
+
+    EngineMovePicker picker(board, moves, hashMove, killers_[0][ply], killers_[1][ply], counterMove,
+                            true, history_, contHist1, contHist2, captureHistory_);
+
+    // the root walks its persistent list (ordered between iterations) instead of the picker
+    const bool rootNode = (ply == 0 && !excluding && (int)rootMoves_.size() > pvIdx_);
+    int rootIdx = rootNode ? pvIdx_ : 0;
 
     Move mv;
     int moveIndex = 0;
 
     while (true) {
-        if (!picker.next(mv)) break;
+        if (rootNode) {
+            if (rootIdx >= (int)rootMoves_.size()) break;
+            mv = rootMoves_[rootIdx++].move;
+        }
+        else if (!picker.next(mv)) break;
+        if (excluding && mv == excludedMove) continue;
+
+        // Singular search: if every other move fails low against ttScore - margin, the TT move
+        // is singular and gets extended; if one also beats beta, cut the whole node (multi-cut).
+        int singularExt = 0;
+        if (singularCandidate && mv == hashMove) {
+            const int singularBeta  = ttScore - cfg_.singularMarginPerPly * depth;
+            const int singularDepth = (depth - 1) / 2;
+
+            Move singularBest = NO_MOVE;
+            const int s = search(board,
+                                 singularDepth,
+                                 singularBeta - 1,
+                                 singularBeta,
+                                 startDepth,
+                                 ply,
+                                 totalExtensions,
+                                 false,
+                                 singularBest,
+                                 timedOut,
+                                 cutNode,
+                                 mv);
+
+            if (timedOut) { bestMoveOut = NO_MOVE; return 0; }
+
+            if (s < singularBeta) singularExt = 1;
+            else if (!pvNode && singularBeta >= beta) {
+                bestMoveOut = NO_MOVE;
+                return singularBeta;
+            }
+        }
+
+        const int movedPiece = board.posToValue(mv.from);
+
+        stack_[ply].move = mv;
+        stack_[ply].piece = movedPiece;
+        stack_[ply].contHist = (movedPiece >= 0 && movedPiece < 12) ? &contHist_[movedPiece * 64 + mv.to] : nullptr;
 
         Undo u;
         Move played = mv;
+        const uint64_t nodesBefore = lastNodes_;
         board.makeMove(played, u);
 
         const bool quiet = (!played.isCapture && !played.promotion);
         if (quiet && quietTriedN < 64) {
             quietTried[quietTriedN++] = played;
         }
+        else if (played.isCapture && captureTriedN < 32) {
+            captureTried[captureTriedN++] = played;
+        }
+
+        const bool givesCheck = board.amIInCheck(board.whiteToMove);
 
         int ext = 0;
         if (totalExtensions < cfg_.maxExtensionsPerLine) {
-            if (board.amIInCheck(board.whiteToMove)) ext = 1;
+            if (givesCheck) ext = 1;
+            ext += singularExt;
         }
-        ext = std::clamp(ext, 0, 2);
+        ext = std::clamp(ext, 0, std::min(2, cfg_.maxExtensionsPerLine - totalExtensions));
+
+        const int newDepth = depth - 1 + ext;
 
+        // LMR: log*log table, then adjust for node type, trend, checks and history
+        // MultiPV sub-lines are reported with their scores: search their root moves unreduced
         int reduction = 0;
-        if (depth >= 4 && quiet && ext == 0 && moveIndex >= 3 && std::abs(alpha) < (MATE_THRESHOLD - 500) && !board.amIInCheck(board.whiteToMove)){
-            reduction = 1;
+        if (depth >= cfg_.lmrMinDepth && quiet && ext == 0 && moveIndex >= (pvNode ? 3 : 2) &&
+            std::abs(alpha) < (MATE_THRESHOLD - 500) && !(rootNode && pvIdx_ > 0))
+        {
+            reduction = lmrTable_[std::min(depth, LMR_DEPTHS - 1)][std::min(moveIndex, LMR_MOVES - 1)];
+
+            if (pvNode) reduction--;
+            if (!improving) reduction++;
+            if (inCheck || givesCheck) reduction--;
+
+            if (movedPiece >= 0 && movedPiece < 12) {
+                int hist = (int)history_[movedPiece][mv.to];
+                if (contHist1) hist += contHist1->v[movedPiece][mv.to];
+                if (contHist2) hist += contHist2->v[movedPiece][mv.to];
+                reduction -= hist / std::max(1, cfg_.lmrHistoryDivisor);
+            }
+
+            // not std::clamp: newDepth - 1 is negative at depth 1 (LmrMinDepth may be 1)
+            reduction = std::max(0, std::min(reduction, newDepth - 1));
         }
 
         Move childBest = NO_MOVE;
         int score;
 
-        // PVS
-        if (moveIndex > 0) {
-            const int child = search(board,
-                                     depth - 1 - reduction + ext,
-                                     -(alpha + 1),
-                                     -alpha,
-                                     startDepth,
-                                     ply + 1,
-                                     totalExtensions + ext,
-                                     false,
-                                     childBest,
-                                     timedOut);
-
-            score = -child;
-
-            // IMPORTANT: with fail-soft scores, this condition behaves properly
-            if (!timedOut && score > alpha && score < beta) {
-                score = -search(board,
-                                depth - 1 - reduction + ext,
-                                -beta,
-                                -alpha,
-                                startDepth,
-                                ply + 1,
-                                totalExtensions + ext,
-                                false,
-                                childBest,
-                                timedOut);
-            }
-        } else {
+        if (moveIndex == 0) {
             score = -search(board,
-                            depth - 1 - reduction + ext,
+                            newDepth,
                             -beta,
                             -alpha,
                             startDepth,
@@ -804,63 +988,135 @@ int Engine::search(Board& board, int depth, int alpha, int beta, int startDepth,
                             totalExtensions + ext,
                             false,
                             childBest,
-                            timedOut);
-        }
+                            timedOut,
+                            !pvNode && !cutNode);
+        } else {
+            if (reduction > 0) countStat(&SearchStats::lmrReduced);
 
-        // LMR re-search
-        if (!timedOut && reduction == 1 && score > alpha) {
-            Move retryBest = NO_MOVE;
+            // PVS null window (reduced for late quiets)
             score = -search(board,
-                            depth - 1 + ext,
-                            -beta,
+                            newDepth - reduction,
+                            -(alpha + 1),
                             -alpha,
                             startDepth,
                             ply + 1,
                             totalExtensions + ext,
                             false,
-                            retryBest,
-                            timedOut);
+                            childBest,
+                            timedOut,
+                            reduction > 0 || !cutNode);
+
+            // LMR verification: a reduced move that beats alpha is re-searched at full depth
+            if (!timedOut && reduction > 0 && score > alpha) {
+                countStat(&SearchStats::lmrResearches);
+                score = -search(board,
+                                newDepth,
+                                -(alpha + 1),
+                                -alpha,
+                                startDepth,
+                                ply + 1,
+                                totalExtensions + ext,
+                                false,
+                                childBest,
+                                timedOut,
+                                !cutNode);
+            }
+
+            // IMPORTANT: with fail-soft scores, this condition behaves properly
+            if (!timedOut && score > alpha && score < beta) {
+                score = -search(board,
+                                newDepth,
+                                -beta,
+                                -alpha,
+                                startDepth,
+                                ply + 1,
+                                totalExtensions + ext,
+                                false,
+                                childBest,
+                                timedOut);
+            }
         }
 
         board.undoMove(played, u);
 
         if (timedOut) { bestMoveOut = NO_MOVE; return 0; }
 
+        if (rootNode) {
+            RootMove& rm = rootMoves_[rootIdx - 1];
+            rm.nodes += lastNodes_ - nodesBefore;
+            rm.score = (moveIndex == 0 || score > alpha) ? score : -1000000;
+        }
+
         if (score > bestScore) {
             bestScore = score;
             bestMoveOut = mv;
         }
 
-        if (score > alpha) alpha = score;
+        if (score > alpha) {
+            alpha = score;
+
+            // PV: this move followed by the child's line
+            PVLine& line = pv_[ply];
+            const PVLine& child = pv_[ply + 1];
+            line.moves[0] = mv;
+            const int n = std::min(child.length, MAX_PLY);
+            std::copy(child.moves, child.moves + n, line.moves + 1);
+            line.length = n + 1;
+        }
 
         if (alpha >= beta) {
+            countStat(&SearchStats::betaCutoffs);
+            if (moveIndex == 0) countStat(&SearchStats::firstMoveCutoffs);
+
             if (quiet) {
                 recordKiller(mv, ply);
 
-                const int bonus = depth * depth;
-                const int malus = bonus / 4;
+                if (ply >= 1 && stack_[ply - 1].piece >= 0) {
+                    counterMoves_[stack_[ply - 1].piece][stack_[ply - 1].move.to] = mv;
+                }
+
+                const int bonus = historyBonus(depth);
 
-                updateHistory(board, mv.from, mv.to, bonus);
+                updateQuietHeuristics(board, ply, mv, bonus);
 
                 for (int qi = 0; qi < quietTriedN; ++qi) {
                     const Move& q = quietTried[qi];
                     if (q == mv) continue;
-                    updateHistory(board, q.from, q.to, -malus);
+                    updateQuietHeuristics(board, ply, q, -bonus);
                 }
             }
+            else if (played.isCapture) {
+                updateCaptureHistory(board, played, historyBonus(depth));
+            }
+
+            // captures that were tried first and failed to cut get a malus either way
+            for (int ci = 0; ci < captureTriedN; ++ci) {
+                const Move& c = captureTried[ci];
+                if (c == mv) continue;
+                updateCaptureHistory(board, c, -historyBonus(depth));
+            }
             break;
         }
 
         moveIndex++;
     }
 
+    // Every legal move was the excluded one: report a fail-low so the caller treats it as singular
+    if (excluding && moveIndex == 0) {
+        bestMoveOut = NO_MOVE;
+        return alpha;
+    }
+
     // TT store
     TTFlag flag;
     if (bestScore <= originalAlpha) flag = HASH_FLAG_UPPER;
     else if (bestScore >= originalBeta) flag = HASH_FLAG_LOWER;
     else flag = HASH_FLAG_EXACT;
 
-    storeTT(key, scoreToTT(bestScore, ply), flag, bestMoveOut, depth);
+    // a MultiPV sub-line saw only part of the root moves: its result must not replace the real root entry
+    if (!(rootNode && pvIdx_ > 0)) {
+        storeTT(key, scoreToTT(bestScore, ply), flag, bestMoveOut, depth);
+    }
 
     return bestScore;
 }
@@ -876,11 +1132,105 @@ int Engine::getTimeLimitMs() const {
 }
 
 Move Engine::getMove(Board& board) {
-    endTime_ = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(cfg_.timeLimitMs);
+    return getMove(board, SearchLimits{});
+}
+
+Move Engine::getMove(Board& board, const SearchLimits& limits) {
+    stop_.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(ponderMutex_);
+        pondering_.store(limits.ponder);
+        ponderClockSet_ = false;
+    }
+    const Move best = think(board, limits, InfoCallback{});
+    if constexpr (kProbesEnabled) probeTotals_ = probes::take();
+    return best;
+}
+
+void Engine::startSearch(const Board& board, const SearchLimits& limits,
+                         InfoCallback onInfo, BestMoveCallback onBestMove) {
+    stop();
+    wait();
+
+    searchBoard_ = board;
+    stop_.store(false, std::memory_order_relaxed);
+    searching_.store(true);
+
+    // marked before the worker starts, so a ponderhit() that arrives first is not lost
+    {
+        std::lock_guard<std::mutex> lock(ponderMutex_);
+        pondering_.store(limits.ponder);
+        ponderClockSet_ = false;
+    }
+
+    searchThread_ = std::thread([this, limits, onInfo = std::move(onInfo), onBestMove = std::move(onBestMove)] {
+        const Move best = think(searchBoard_, limits, onInfo);
+        if constexpr (kProbesEnabled) probeTotals_ = probes::take();
+        asyncBest_ = best;
+        searching_.store(false);
+        if (onBestMove) onBestMove(best);
+    });
+}
+
+void Engine::stop() {
+    stop_.store(true, std::memory_order_relaxed);
+}
+
+Move Engine::wait() {
+    if (searchThread_.joinable()) searchThread_.join();
+    return asyncBest_;
+}
+
+void Engine::ponderhit() {
+    std::lock_guard<std::mutex> lock(ponderMutex_);
+    if (!pondering_.load()) return;
+
+    // think() has not started the clock yet: it will run as a normal timed search
+    if (!ponderClockSet_) {
+        pondering_.store(false);
+        return;
+    }
+
+    // keep everything searched so far; only the clock starts now
+    timeMgr_.restartClock();
+    if (ponderTimed_) stopTimer_.arm(timeMgr_.hardDeadline(), stop_);
+    pondering_.store(false);
+}
+
+Move Engine::ponderMove() const {
+    return (lastPv_.size() >= 2) ? lastPv_[1] : NO_MOVE;
+}
+
+Move Engine::think(Board& board, const SearchLimits& limits, const InfoCallback& onInfo) {
+    searchStart_ = TimeManager::Clock::now();
+    timeMgr_.start(limits, cfg_.timeLimitMs, cfg_.moveOverheadMs);
+
+    // depth/node-only and infinite searches have no deadline; plain getMove(board) keeps the fixed per-move time
+    const bool timed = !limits.infinite && (limits.hasClock() || (limits.depth <= 0 && limits.nodes == 0));
+    {
+        std::lock_guard<std::mutex> lock(ponderMutex_);
+        ponderClockSet_ = true;
+        ponderTimed_ = timed;
+        if (timed && !pondering_.load()) stopTimer_.arm(timeMgr_.hardDeadline(), stop_);
+    }
+
+    nodeLimit_ = limits.nodes;
+
+    // config() is writable at any time (setoption, tuners): pick up new LMR parameters
+    if (cfg_.lmrBase != lmrTableBase_ || cfg_.lmrDivisor != lmrTableDivisor_) initReductions();
+    const int maxDepth = (limits.depth > 0) ? std::min(limits.depth, cfg_.maxDepth) : cfg_.maxDepth;
+
+    ++ttGen_;
     rootSideIsWhite_ = board.whiteToMove;
     lastNodes_ = 0;
     lastDepth_ = 0;
     lastEval_  = 0;
+    selDepth_  = 0;
+    pvIdx_     = 0;
+    lastPv_.clear();
+    lastLines_.clear();
+    if constexpr (kSearchStatsEnabled) stats_.clear();
+    if constexpr (kProbesEnabled) probes::take(); // drop anything this thread probed outside a search
 
     Move bestMove = NO_MOVE;
     int bestScore = 0;
@@ -890,15 +1240,33 @@ Move Engine::getMove(Board& board) {
 
     bool timedOut = false;
 
+    MoveList rootMoves;
+    board.generateAllMoves(rootMoves);
+
+    rootMoves_.clear();
+    for (int i = 0; i < rootMoves.size; ++i) {
+        RootMove rm;
+        rm.move = rootMoves.m[i];
+        rootMoves_.push_back(rm);
+    }
+
     auto matePlies = [&](int s) -> int {
         if (std::abs(s) < MATE_THRESHOLD) return 999999;
         return MATE_SCORE - std::abs(s); // plies to mate from root
     };
 
-    for (int depth = 1; depth <= cfg_.maxDepth; ++depth) {
+    for (int depth = 1; depth <= maxDepth; ++depth) {
         Move rootBest = NO_MOVE;
         timedOut = false;
 
+        const uint64_t iterationStartNodes = lastNodes_;
+
+        for (RootMove& rm : rootMoves_) {
+            rm.prevScore = rm.score;
+            rm.score = -1000000;
+            rm.nodes = 0;
+        }
+
         // If we're already in mate territory, aspiration is more harm than help.
         const bool prevIsMate = (std::abs(prevScore) >= MATE_THRESHOLD);
 
@@ -911,19 +1279,18 @@ Move Engine::getMove(Board& board) {
             beta  = prevScore + window;
 
             if (cfg_.useOpeningBook) {
-                static OpeningBook book;
-                static bool loaded = false;
-
-                if (!loaded) {
-                    book.load("opening_book.bin");
-                    loaded = true;
-                }
+                if (!book_) book_ = loadOpeningBook("opening_book.bin");
 
                 Move bookMove;
-                if (book.probe(board.zobristHash, bookMove)) {
-                    std::cout << "Used opening book" << std::endl;
-                    std::cout << bookMove.from << bookMove.to << std::endl;
-                    return bookMove;
+                if (book_->probe(board.zobristHash, bookMove)) {
+                    // stderr: stdout belongs to the UCI protocol when running headless
+                    std::cerr << "Used opening book" << std::endl;
+                    std::cerr << bookMove.from << bookMove.to << std::endl;
+                    bestMove = bookMove;
+                    lastPv_.assign(1, bookMove);
+                    lastLines_.assign(1, SearchInfo{});
+                    lastLines_[0].pv = lastPv_;
+                    break;
                 }
             }
 
@@ -932,9 +1299,11 @@ Move Engine::getMove(Board& board) {
                 rootBest = NO_MOVE;
                 int score = search(board, depth, alpha, beta, depth, 0, 0, false, rootBest, timedOut);
                 if (timedOut) break;
+                sortRootMoves();
 
                 // fail-low => widen down
                 if (score <= alpha) {
+                    countStat(&SearchStats::aspirationFailLow);
                     window *= cfg_.aspirationGrowFactor;
                     alpha = prevScore - window;
                     beta  = prevScore + window;
@@ -943,6 +1312,7 @@ Move Engine::getMove(Board& board) {
 
                 // fail-high => widen up
                 if (score >= beta) {
+                    countStat(&SearchStats::aspirationFailHigh);
                     window *= cfg_.aspirationGrowFactor;
                     alpha = prevScore - window;
                     beta  = prevScore + window;
@@ -968,6 +1338,7 @@ Move Engine::getMove(Board& board) {
         } else {
             int score = search(board, depth, alpha, beta, depth, 0, 0, false, rootBest, timedOut);
             if (timedOut) break;
+            sortRootMoves();
 
             if (rootBest.from != -1 && rootBest.to != -1) {
                 bestMove = rootBest;
@@ -984,18 +1355,189 @@ Move Engine::getMove(Board& board) {
 
         prevBest = bestMove;
 
+        // triangular PV from the root, extended from the TT where a cutoff truncated it
+        auto rootLine = [&](const Move& first) {
+            std::vector<Move> line(pv_[0].moves, pv_[0].moves + pv_[0].length);
+            if (line.empty() || line[0] != first) line.assign(1, first);
+            return extractPV(board, line, std::max(depth, (int)line.size()));
+        };
+
+        auto makeInfo = [&](int lineNo, int score, std::vector<Move> pv) {
+            SearchInfo info;
+            info.depth = depth;
+            info.seldepth = selDepth_;
+            info.score = score;
+            info.nodes = lastNodes_;
+            // from the start of the search, pondering included, so time matches the node count
+            info.timeMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                TimeManager::Clock::now() - searchStart_).count();
+            info.nps = lastNodes_ * 1000ull / (uint64_t)std::max(1, info.timeMs);
+            info.hashfull = hashfull();
+            info.multiPV = lineNo;
+            info.pv = std::move(pv);
+            return info;
+        };
+
+        lastPv_ = rootLine(bestMove);
+
+        std::vector<SearchInfo> lines;
+        lines.push_back(makeInfo(1, bestScore, lastPv_));
+
+        // MultiPV: each further line searches the remaining root moves with the better lines excluded;
+        // TT and heuristics are shared, so later lines are cheap compared to separate searches
+        const int numLines = std::min((int)rootMoves_.size(), std::max(1, cfg_.multiPV));
+        for (pvIdx_ = 1; pvIdx_ < numLines; ++pvIdx_) {
+            const int center = rootMoves_[pvIdx_].prevScore;
+            const bool useWindow = depth > 1 && std::abs(center) < MATE_THRESHOLD;
+
+            int window = cfg_.aspirationStartWindow;
+            int lineAlpha = useWindow ? center - window : -999999;
+            int lineBeta  = useWindow ? center + window :  999999;
+            int lineScore = 0;
+            Move lineBest = NO_MOVE;
+
+            while (true) {
+                lineBest = NO_MOVE;
+                lineScore = search(board, depth, lineAlpha, lineBeta, depth, 0, 0, false, lineBest, timedOut);
+                if (timedOut) break;
+                sortRootMoves();
+
+                if (useWindow && (lineScore <= lineAlpha || lineScore >= lineBeta)) {
+                    countStat(lineScore <= lineAlpha ? &SearchStats::aspirationFailLow : &SearchStats::aspirationFailHigh);
+                    window *= cfg_.aspirationGrowFactor;
+                    lineAlpha = center - window;
+                    lineBeta  = center + window;
+                    continue;
+                }
+                break;
+            }
+            if (timedOut || lineBest == NO_MOVE) break;
+
+            rootMoves_[pvIdx_].score = lineScore;
+            lines.push_back(makeInfo(pvIdx_ + 1, lineScore, rootLine(lineBest)));
+        }
+        pvIdx_ = 0;
+
+        // each line had its own window, so a later line can outscore an earlier one: report
+        // (and keep for the next iteration) best first, the same stable order for both
+        if (lines.size() > 1) {
+            rootMoves_[0].score = bestScore;
+            auto byScore = [](const auto& a, const auto& b) { return a.score > b.score; };
+            std::stable_sort(rootMoves_.begin(), rootMoves_.begin() + lines.size(), byScore);
+            std::stable_sort(lines.begin(), lines.end(), byScore);
+            for (size_t k = 0; k < lines.size(); ++k) lines[k].multiPV = (int)k + 1;
+
+            if (!lines[0].pv.empty() && lines[0].pv[0] != bestMove) {
+                bestMove = prevBest = lines[0].pv[0];
+                bestScore = prevScore = lastEval_ = lines[0].score;
+                lastPv_ = lines[0].pv;
+            }
+        }
+
+        if constexpr (kSearchStatsEnabled) {
+            if (!timedOut) stats_.iterationNodes.push_back(lastNodes_ - iterationStartNodes);
+            stats_.selDepth = selDepth_;
+        }
+
+        lastLines_ = lines;
+        if (onInfo) {
+            for (const SearchInfo& info : lines) onInfo(info);
+        }
+        if (timedOut) break;
+
         // Mate early exit: only stop once depth is sufficient to prove the mate distance.
         const int m = matePlies(bestScore);
         if (m != 999999) {
             if (depth >= m) break;
         }
 
+        // Only one legal reply: nothing to think about once we have a move and an eval
+        if (rootMoves.size == 1) break;
+
         if (outOfTime()) break;
+
+        std::lock_guard<std::mutex> lock(ponderMutex_);
+        timeMgr_.onIteration(depth, bestMove, bestScore);
+        if (!pondering_.load() && timeMgr_.shouldStop()) break;
+    }
+
+    // infinite/ponder: the result may only be reported after stop() (or ponderhit())
+    while ((limits.infinite || pondering_.load()) && !outOfTime()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
+    {
+        std::lock_guard<std::mutex> lock(ponderMutex_);
+        pondering_.store(false);
+        stopTimer_.disarm();
+    }
+    nodeLimit_ = 0;
+
+    if (bestMove == NO_MOVE && rootMoves.size > 0) bestMove = rootMoves.m[0];
     return bestMove;
 }
 
+void Engine::sortRootMoves() {
+    // best score first; moves that failed low (no exact score) by how much effort they took.
+    // MultiPV: lines already found this iteration keep their place.
+    std::stable_sort(rootMoves_.begin() + pvIdx_, rootMoves_.end(), [](const RootMove& a, const RootMove& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.nodes > b.nodes;
+    });
+}
+
+std::vector<Move> Engine::extractPV(Board& board, const std::vector<Move>& line, int maxLen) {
+    // Replay the given line, then follow TT moves; every move is verified legal.
+    // Stops on a miss or a repeated position.
+    std::vector<Move> pv;
+    std::vector<std::pair<Move, Undo>> played;
+    std::unordered_set<uint64_t> seen;
+
+    while ((int)pv.size() < maxLen) {
+        const uint64_t key = board.zobristHash;
+        if (!seen.insert(key).second) break;
+
+        Move want = NO_MOVE;
+        if (pv.size() < line.size()) {
+            want = line[pv.size()];
+        } else {
+            EngineTTEntry* e = probeTT(key);
+            if (!e || e->key != key || e->move == NO_MOVE) break;
+            want = e->move;
+        }
+
+        MoveList legal;
+        board.generateAllMoves(legal);
+
+        bool found = false;
+        Move mv = NO_MOVE;
+        for (int i = 0; i < legal.size; ++i) {
+            if (legal.m[i] == want) { mv = legal.m[i]; found = true; break; }
+        }
+        if (!found) break;
+
+        pv.push_back(mv);
+        played.push_back({ mv, Undo{} });
+        board.makeMove(played.back().first, played.back().second);
+    }
+
+    for (auto it = played.rbegin(); it != played.rend(); ++it) {
+        board.undoMove(it->first, it->second);
+    }
+    return pv;
+}
+
+int Engine::hashfull() const {
+    const size_t n = std::min<size_t>(1000, tt_.size());
+    if (n == 0) return 0;
+
+    size_t used = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (tt_[i].depth != -1 && tt_[i].gen == ttGen_) ++used;
+    }
+    return (int)(used * 1000 / n);
+}
+
 size_t Engine::transpositionSize() const {
     size_t used = 0;
     for (const auto& e : tt_) {
@@ -1010,6 +1552,8 @@ void Engine::printAfterMoveDebug(Engine& engine, Board& board) {
     std::cout << "Search depth reached: " << engine.lastDepth_ << "\n";
     std::cout << "Positions evaluated: " << engine.lastNodes_ << "\n";
     std::cout << "Eval: " << engine.lastEval_ << "\n";
+    if constexpr (kSearchStatsEnabled) engine.stats_.print(std::cout);
+    if constexpr (kProbesEnabled) engine.probeTotals_.print(std::cout);
     board.printBoard(); 
     std::cout << "====================================================\n";
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 // ========================= engine_match.cpp =========================
 #include "engine.h"
+#include "opening_book.h"
 #include "BoardDisplay.h"
 #include "zobrist.h"
 
@@ -18,7 +19,9 @@
 #include <optional>
 #include <algorithm>
 #include <bit>
+#include <cmath>
 #include <iomanip>
+#include <sstream>
 #include <random>
 #include <memory>
 
@@ -548,12 +551,118 @@ static GameResult playOne(Board& board,
     return GameResult::Draw;
 }
 
+// ----------------------------
+// SPRT on game pairs. Both colour games of one FEN form a pair; B's points in the pair
+// (0, 0.5, 1, 1.5 or 2) go into one of five buckets. Pairs cancel most of the opening bias,
+// so their variance is lower than that of single games and the test needs fewer games.
+struct SprtConfig {
+    bool enabled = false;
+    double elo0 = 0.0;    // H0: B is at most elo0 stronger than A
+    double elo1 = 5.0;    // H1: B is at least elo1 stronger than A
+    double alpha = 0.05;  // chance of accepting H1 when H0 is true
+    double beta  = 0.05;  // chance of accepting H0 when H1 is true
+    int minPairs = 8;     // no decision before this many pairs (a few identical pairs have ~zero variance)
+};
+
+enum class SprtDecision { None, AcceptH0, AcceptH1 };
+
+struct SprtResult {
+    SprtDecision decision = SprtDecision::None;
+    double llr = 0.0;
+    double lower = 0.0;
+    double upper = 0.0;
+};
+
+struct EloEstimate {
+    double elo = 0.0;
+    double error = 0.0; // 95% confidence half-width
+};
+
+static int pairBucket(double pairPointsB) {
+    return (int)std::lround(pairPointsB * 2.0); // 0..4
+}
+
+static double eloToScore(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+static double scoreToElo(double score) {
+    score = std::max(1e-6, std::min(1.0 - 1e-6, score));
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// Mean and variance of B's per-pair score (pair points / 2). pseudo is added to every bucket
+// so a run of identical pairs (e.g. all draws) does not give zero variance.
+static double pairMoments(const int penta[5], double pseudo, double& mean, double& var) {
+    double n = 0.0, sum = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        n += penta[i] + pseudo;
+        sum += (penta[i] + pseudo) * (i / 4.0);
+    }
+    mean = sum / n;
+    var = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        const double d = i / 4.0 - mean;
+        var += (penta[i] + pseudo) * d * d;
+    }
+    var /= n;
+    return n;
+}
+
+static EloEstimate eloFromPairs(const int penta[5]) {
+    EloEstimate e;
+    int pairs = 0;
+    for (int i = 0; i < 5; ++i) pairs += penta[i];
+    if (pairs == 0) return e;
+
+    double mean = 0.0, var = 0.0;
+    pairMoments(penta, 0.0, mean, var);
+    const double margin = 1.96 * std::sqrt(var / pairs);
+    e.elo = scoreToElo(mean);
+    e.error = (scoreToElo(mean + margin) - scoreToElo(mean - margin)) / 2.0;
+    return e;
+}
+
+// Generalised SPRT with the normal approximation used by fishtest: the log-likelihood ratio of
+// "mean pair score = score(elo1)" against "= score(elo0)" given the observed mean and variance.
+static SprtResult sprtTest(const int penta[5], const SprtConfig& cfg) {
+    SprtResult r;
+    r.lower = std::log(cfg.beta / (1.0 - cfg.alpha));
+    r.upper = std::log((1.0 - cfg.beta) / cfg.alpha);
+
+    int pairs = 0;
+    for (int i = 0; i < 5; ++i) pairs += penta[i];
+
+    double mean = 0.0, var = 0.0;
+    const double n = pairMoments(penta, 1e-3, mean, var);
+    if (var <= 0.0) return r;
+
+    const double s0 = eloToScore(cfg.elo0);
+    const double s1 = eloToScore(cfg.elo1);
+    r.llr = n * (s1 - s0) * (2.0 * mean - s0 - s1) / (2.0 * var);
+
+    if (pairs < cfg.minPairs) return r;
+    if (r.llr >= r.upper) r.decision = SprtDecision::AcceptH1;
+    else if (r.llr <= r.lower) r.decision = SprtDecision::AcceptH0;
+    return r;
+}
+
+static const char* sprtDecisionName(SprtDecision d) {
+    switch (d) {
+        case SprtDecision::AcceptH0: return "H0 accepted";
+        case SprtDecision::AcceptH1: return "H1 accepted";
+        default:                     return "inconclusive";
+    }
+}
+
 // ----------------------------
 // Generic A/B runner (this is the new reusable testing function)
 struct MatchRunConfig {
     int totalGamesWanted = 200;   // total games (not positions). We’ll do color-swaps.
     bool useUI = false;           // headless by default (important for tuning speed/noise)
     bool verbose = true;
+    int workers = 0;              // headless games played concurrently (0 = one per hardware thread)
+    SprtConfig sprt;              // when enabled, stop as soon as the test decides (totalGamesWanted is the cap)
 };
 
 struct MatchResultAB {
@@ -562,8 +671,184 @@ struct MatchResultAB {
     int totalGamesPlayed = 0;
     double scoreA = 0.0; // points/game (win=1, draw=0.5)
     double scoreB = 0.0;
+    int workers = 1;
+    double seconds = 0.0;
+    double gamesPerHour = 0.0;
+
+    int penta[5] = {};      // completed pairs by B's points: 0, 0.5, 1, 1.5, 2
+    EloEstimate elo;        // B relative to A, from the pairs
+    SprtResult sprt;        // decision stays None unless rcfg.sprt.enabled
 };
 
+// decided: the decision that stopped the match early, if any (later pairs already in flight
+// are still counted, but do not undo it).
+static void finishResult(MatchResultAB& out, const Stats& stats, const int penta[5], SprtDecision decided,
+                         std::chrono::steady_clock::time_point start, const MatchRunConfig& rcfg) {
+    std::copy(penta, penta + 5, out.penta);
+    out.elo = eloFromPairs(penta);
+    if (rcfg.sprt.enabled) {
+        out.sprt = sprtTest(penta, rcfg.sprt);
+        if (decided != SprtDecision::None) out.sprt.decision = decided;
+    }
+
+    out.stats = stats;
+    out.totalGamesPlayed = stats.games;
+    out.scoreA = scoreFromStatsForA(stats);
+    out.scoreB = scoreFromStatsForB(stats);
+    out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    out.gamesPerHour = out.seconds > 0.0 ? (double)stats.games * 3600.0 / out.seconds : 0.0;
+
+    if (rcfg.verbose) {
+        std::cout << "\nFinal: "
+                  << "A wins=" << stats.aWins
+                  << " | B wins=" << stats.bWins
+                  << " | draws=" << stats.draws
+                  << " | games=" << stats.games
+                  << "\n";
+        std::cout << "Score: A=" << std::fixed << std::setprecision(4) << out.scoreA
+                  << " | B=" << out.scoreB << "\n";
+        std::cout << "Pairs (B 0/0.5/1/1.5/2): " << penta[0] << " " << penta[1] << " " << penta[2]
+                  << " " << penta[3] << " " << penta[4] << "\n";
+        std::cout << std::setprecision(1) << "Elo (B vs A): " << out.elo.elo << " +/- " << out.elo.error << "\n";
+        if (rcfg.sprt.enabled) {
+            std::cout << std::setprecision(2) << "SPRT [" << rcfg.sprt.elo0 << ", " << rcfg.sprt.elo1 << "]: LLR="
+                      << out.sprt.llr << " (" << out.sprt.lower << ", " << out.sprt.upper << ") "
+                      << sprtDecisionName(out.sprt.decision) << "\n";
+        }
+        std::cout << std::setprecision(1) << stats.games << " games in " << out.seconds << "s on "
+                  << out.workers << (out.workers == 1 ? " worker" : " workers")
+                  << " (" << std::setprecision(0) << out.gamesPerHour << " games/hour)\n";
+    }
+}
+
+// Headless runner. Each worker thread owns an Engine pair and a Board and claims positions
+// (both colour games of one FEN) from a shared cursor; results go into atomic counters.
+// Nothing is logged while games run: workers write no files, and only the calling thread
+// prints progress.
+static MatchResultAB runABMatchParallel(const std::vector<std::string>& fens,
+                                        int totalGames,
+                                        const EngineConfig& cfgA,
+                                        const EngineConfig& cfgB,
+                                        const MatchRunConfig& rcfg) {
+    MatchResultAB out;
+    out.totalGamesRequested = rcfg.totalGamesWanted;
+
+    const int positions = (totalGames + 1) / 2;
+    const int wanted = rcfg.workers > 0 ? rcfg.workers : (int)std::max(1u, std::thread::hardware_concurrency());
+    out.workers = std::max(1, std::min(wanted, positions));
+
+    // loaded once and shared read-only by every engine
+    std::shared_ptr<const OpeningBook> book;
+    if (cfgA.useOpeningBook || cfgB.useOpeningBook) book = loadOpeningBook("opening_book.bin");
+
+    // playOne only changes these from UI input, so headless they stay fixed
+    std::atomic<int> thinkMs{ cfgA.timeLimitMs };
+    std::atomic<bool> paused{ false };
+    std::atomic<bool> stopRequested{ false };
+
+    std::atomic<int> nextPos{ 0 };
+    std::atomic<int> aWins{ 0 }, bWins{ 0 }, draws{ 0 };
+    std::atomic<int> gamesDone{ 0 };
+    std::atomic<int> penta[5] = {};
+    std::atomic<int> decided{ (int)SprtDecision::None }; // first SPRT decision; stops new pairs being claimed
+
+    if (rcfg.verbose) {
+        std::cout << "Running A/B: " << totalGames << " games using " << positions << " positions on "
+                  << out.workers << (out.workers == 1 ? " worker" : " workers") << ".\n";
+        std::cout << "Time(ms): A=" << cfgA.timeLimitMs << " B=" << cfgB.timeLimitMs << "\n";
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    pool.reserve(out.workers);
+    for (int w = 0; w < out.workers; ++w) {
+        pool.emplace_back([&] {
+            Engine engineA(cfgA);
+            Engine engineB(cfgB);
+            if (book) {
+                engineA.setOpeningBook(book);
+                engineB.setOpeningBook(book);
+            }
+            Board board;
+
+            for (int i = nextPos.fetch_add(1);
+                 i < positions && decided.load() == (int)SprtDecision::None;
+                 i = nextPos.fetch_add(1)) {
+                double pairPointsB = 0.0;
+                int pairGames = 0;
+
+                // game 1: A(W) vs B(B), game 2: B(W) vs A(B)
+                for (int g = 0; g < 2 && i * 2 + g < totalGames; ++g) {
+                    const bool aWhite = (g == 0);
+                    board.createBoardFromFEN(fens[i]);
+                    board.zobristHash = board.generateZobristHash();
+
+                    engineA.setTimeLimitMs(thinkMs.load());
+                    engineB.setTimeLimitMs(thinkMs.load());
+
+                    GameResult r = playOne(board,
+                                           aWhite ? engineA : engineB,
+                                           aWhite ? engineB : engineA,
+                                           nullptr, nullptr, nullptr,
+                                           thinkMs, paused, stopRequested,
+                                           0, 0, 0,
+                                           i + 1, positions,
+                                           g + 1, 2,
+                                           std::string(),
+                                           cfgA.maxGamePlies);
+
+                    if (r == GameResult::Draw) { draws.fetch_add(1); pairPointsB += 0.5; }
+                    else if ((r == GameResult::WhiteWin) == aWhite) aWins.fetch_add(1);
+                    else { bWins.fetch_add(1); pairPointsB += 1.0; }
+                    gamesDone.fetch_add(1);
+                    pairGames++;
+                }
+
+                // a lone last game (odd totalGames) only counts towards the W/D/L stats
+                if (pairGames < 2) continue;
+                penta[pairBucket(pairPointsB)].fetch_add(1);
+
+                if (rcfg.sprt.enabled) {
+                    int snapshot[5];
+                    for (int k = 0; k < 5; ++k) snapshot[k] = penta[k].load();
+                    const SprtResult t = sprtTest(snapshot, rcfg.sprt);
+                    int none = (int)SprtDecision::None;
+                    if (t.decision != SprtDecision::None) decided.compare_exchange_strong(none, (int)t.decision);
+                }
+            }
+        });
+    }
+
+    if (rcfg.verbose) {
+        int reported = 0;
+        while (reported < totalGames) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            if (decided.load() != (int)SprtDecision::None) break;
+            const int done = gamesDone.load();
+            if (done == reported) continue;
+            reported = done;
+            std::cout << "Games " << done << "/" << totalGames << ": "
+                      << "A wins=" << aWins.load()
+                      << " | B wins=" << bWins.load()
+                      << " | draws=" << draws.load()
+                      << "\n";
+        }
+    }
+    for (std::thread& t : pool) t.join();
+
+    Stats stats;
+    stats.aWins = aWins.load();
+    stats.bWins = bWins.load();
+    stats.draws = draws.load();
+    stats.games = stats.aWins + stats.bWins + stats.draws;
+
+    int pairs[5];
+    for (int k = 0; k < 5; ++k) pairs[k] = penta[k].load();
+    finishResult(out, stats, pairs, (SprtDecision)decided.load(), start, rcfg);
+    return out;
+}
+
 static MatchResultAB runABMatchSeries(const std::vector<std::string>& allFens,
                                      const EngineConfig& cfgAIn,
                                      const EngineConfig& cfgBIn,
@@ -580,6 +865,11 @@ static MatchResultAB runABMatchSeries(const std::vector<std::string>& allFens,
         return out;
     }
 
+    // the board window needs the games on this thread, one at a time
+    if (!rcfg.useUI) {
+        return runABMatchParallel(fens, totalGames, cfgAIn, cfgBIn, rcfg);
+    }
+
     EngineConfig cfgA = cfgAIn;
     EngineConfig cfgB = cfgBIn;
 
@@ -624,16 +914,23 @@ static MatchResultAB runABMatchSeries(const std::vector<std::string>& allFens,
     Board board;
 
     int gamesPlayed = 0;
+    int penta[5] = {};
+    SprtDecision decided = SprtDecision::None;
 
     if (rcfg.verbose) {
         std::cout << "Running A/B: " << totalGames << " games using " << fens.size() << " positions.\n";
         std::cout << "Time(ms): A=" << cfgA.timeLimitMs << " B=" << cfgB.timeLimitMs << "\n";
     }
 
+    const auto start = std::chrono::steady_clock::now();
+
     for (size_t i = 0; i < fens.size() && !stopRequested.load() && gamesPlayed < totalGames; ++i) {
         const std::string& fenStr = fens[i];
         int posIndex1Based = (int)i + 1;
 
+        const int gamesBefore = stats.games;
+        const double pointsBBefore = stats.bWins + 0.5 * stats.draws;
+
         // Game 1: A(W) vs B(B)
         if (gamesPlayed < totalGames) {
             board.createBoardFromFEN(fenStr);
@@ -697,24 +994,18 @@ static MatchResultAB runABMatchSeries(const std::vector<std::string>& allFens,
                       << " | games=" << stats.games
                       << "\n";
         }
-    }
-
-    out.stats = stats;
-    out.totalGamesPlayed = stats.games;
-    out.scoreA = scoreFromStatsForA(stats);
-    out.scoreB = scoreFromStatsForB(stats);
 
-    if (rcfg.verbose) {
-        std::cout << "\nFinal: "
-                  << "A wins=" << stats.aWins
-                  << " | B wins=" << stats.bWins
-                  << " | draws=" << stats.draws
-                  << " | games=" << stats.games
-                  << "\n";
-        std::cout << "Score: A=" << std::fixed << std::setprecision(4) << out.scoreA
-                  << " | B=" << out.scoreB << "\n";
+        // a game cut short by the window closing is not a real result
+        if (stats.games - gamesBefore == 2 && !stopRequested.load()) {
+            penta[pairBucket(stats.bWins + 0.5 * stats.draws - pointsBBefore)]++;
+            if (rcfg.sprt.enabled) {
+                decided = sprtTest(penta, rcfg.sprt).decision;
+                if (decided != SprtDecision::None) break;
+            }
+        }
     }
 
+    finishResult(out, stats, penta, decided, start, rcfg);
     return out;
 }
 
@@ -769,7 +1060,7 @@ static void clampPieceValues(PieceValues& pv) {
 }
 
 struct PieceTuningConfig {
-    int gamesPerEval = 200;
+    int gamesPerEval = 200; // with SPRT: the most games one evaluation may take
 
     // Keep this bounded or you’ll end up doing thousands of games per tuning pass
     int randomTrials = 12;
@@ -781,6 +1072,13 @@ struct PieceTuningConfig {
     // accept only if B gains at least this many "points" over best (win=1, draw=0.5)
     // 200 games => 1 point = 0.005 score
     double minPointGainToAccept = 2.0; // i.e. +2 points over 200 games (≈ +1% absolute score)
+
+    int workers = 0; // games played concurrently per evaluation (0 = one per hardware thread)
+
+    // When enabled, each candidate plays the current best directly and is accepted when the SPRT
+    // accepts H1; clearly worse candidates are rejected after a fraction of gamesPerEval.
+    // minPointGainToAccept then only decides matches that hit the game cap undecided.
+    SprtConfig sprt;
 };
 
 static PieceValues tunePieceValuesVsBaseline(const std::vector<std::string>& allFens,
@@ -800,31 +1098,57 @@ static PieceValues tunePieceValuesVsBaseline(const std::vector<std::string>& all
     rcfg.totalGamesWanted = totalGames;
     rcfg.useUI = false;
     rcfg.verbose = false;
-
-    auto evalCandidate = [&](const PieceValues& pv) -> MatchResultAB {
-        EngineConfig cfgB = baselineCfgA;
-        applyPieceValues(cfgB, pv);
-        return runABMatchSeries(fensFixed, baselineCfgA, cfgB, rcfg);
-    };
+    rcfg.workers = tc.workers;
+    rcfg.sprt = tc.sprt;
 
     auto pointsB = [](const MatchResultAB& r) -> double {
         return (double)r.stats.bWins + 0.5 * (double)r.stats.draws;
     };
 
+    auto resultToString = [&](const MatchResultAB& r) -> std::string {
+        std::string s = " -> B: W=" + std::to_string(r.stats.bWins)
+            + " D=" + std::to_string(r.stats.draws)
+            + " L=" + std::to_string(r.stats.aWins)
+            + " | scoreB=" + std::to_string(r.scoreB);
+        if (tc.sprt.enabled) {
+            std::ostringstream os;
+            os << std::fixed << std::setprecision(1) << " | elo=" << r.elo.elo << "+/-" << r.elo.error
+               << std::setprecision(2) << " | LLR=" << r.sprt.llr << " " << sprtDecisionName(r.sprt.decision)
+               << " after " << r.stats.games << " games";
+            s += os.str();
+        }
+        return s;
+    };
+
     // start at baseline values (so we measure improvements vs "old")
     PieceValues best = getPieceValuesFromCfg(baselineCfgA);
     clampPieceValues(best);
 
-    MatchResultAB bestRes = evalCandidate(best);
-    double bestPoints = pointsB(bestRes);
+    // Without SPRT every candidate plays the baseline and is compared with the best score so far;
+    // with SPRT it plays the current best and the test decides.
+    auto evalCandidate = [&](const PieceValues& pv) -> MatchResultAB {
+        EngineConfig cfgA = baselineCfgA;
+        EngineConfig cfgB = baselineCfgA;
+        if (tc.sprt.enabled) applyPieceValues(cfgA, best);
+        applyPieceValues(cfgB, pv);
+        return runABMatchSeries(fensFixed, cfgA, cfgB, rcfg);
+    };
 
-    {
-        std::string s = "[TUNE] Baseline (B==A values) "
-            + pvToString(best)
-            + " -> B: W=" + std::to_string(bestRes.stats.bWins)
-            + " D=" + std::to_string(bestRes.stats.draws)
-            + " L=" + std::to_string(bestRes.stats.aWins)
-            + " | scoreB=" + std::to_string(bestRes.scoreB);
+    MatchResultAB bestRes;
+    double bestPoints = 0.0;
+
+    auto accepts = [&](const MatchResultAB& r) -> bool {
+        if (!tc.sprt.enabled) return pointsB(r) > bestPoints + tc.minPointGainToAccept;
+        if (r.sprt.decision != SprtDecision::None) return r.sprt.decision == SprtDecision::AcceptH1;
+        return pointsB(r) - ((double)r.stats.aWins + 0.5 * (double)r.stats.draws) > tc.minPointGainToAccept;
+    };
+
+    // the baseline self-match only gives the fixed-games rule its reference score
+    if (!tc.sprt.enabled) {
+        bestRes = evalCandidate(best);
+        bestPoints = pointsB(bestRes);
+
+        std::string s = "[TUNE] Baseline (B==A values) " + pvToString(best) + resultToString(bestRes);
         std::cout << s << "\n";
         logLine(s);
     }
@@ -848,21 +1172,16 @@ static PieceValues tunePieceValuesVsBaseline(const std::vector<std::string>& all
         clampPieceValues(cand);
 
         MatchResultAB r = evalCandidate(cand);
-        double p = pointsB(r);
 
         std::string line = "[TUNE][RAND " + std::to_string(t+1) + "/" + std::to_string(tc.randomTrials) + "] "
-            + pvToString(cand)
-            + " -> B: W=" + std::to_string(r.stats.bWins)
-            + " D=" + std::to_string(r.stats.draws)
-            + " L=" + std::to_string(r.stats.aWins)
-            + " | scoreB=" + std::to_string(r.scoreB);
+            + pvToString(cand) + resultToString(r);
         std::cout << line << "\n";
         logLine(line);
 
-        if (p > bestPoints + tc.minPointGainToAccept) {
+        if (accepts(r)) {
             best = cand;
             bestRes = r;
-            bestPoints = p;
+            bestPoints = pointsB(r);
 
             std::string acc = "  ACCEPT -> best now " + pvToString(best) + " (scoreB=" + std::to_string(bestRes.scoreB) + ")";
             std::cout << acc << "\n";
@@ -887,21 +1206,16 @@ static PieceValues tunePieceValuesVsBaseline(const std::vector<std::string>& all
 
                 MatchResultAB r = evalCandidate(cand);
                 evalsUsed++;
-                double p = pointsB(r);
 
                 std::string line = "[TUNE][HC step=" + std::to_string(step) + " " + std::string(tag) + "] "
-                    + pvToString(cand)
-                    + " -> B: W=" + std::to_string(r.stats.bWins)
-                    + " D=" + std::to_string(r.stats.draws)
-                    + " L=" + std::to_string(r.stats.aWins)
-                    + " | scoreB=" + std::to_string(r.scoreB);
+                    + pvToString(cand) + resultToString(r);
                 std::cout << line << "\n";
                 logLine(line);
 
-                if (p > bestPoints + tc.minPointGainToAccept) {
+                if (accepts(r)) {
                     best = cand;
                     bestRes = r;
-                    bestPoints = p;
+                    bestPoints = pointsB(r);
                     improved = true;
 
                     std::string acc = "  ACCEPT -> best now " + pvToString(best) + " (scoreB=" + std::to_string(bestRes.scoreB) + ")";
@@ -952,6 +1266,7 @@ int main() {
     // ---- choose mode here (no CLI args) ----
     constexpr bool kTunePieceValues = false;   // <- set false to go back to normal A vs B match UI
     constexpr bool kShowUIInMatch   = true;   // only used when kTunePieceValues==false
+    constexpr int  kMatchWorkers    = 0;      // headless games in parallel (0 = one per hardware thread)
 
     // ---------------- Configure engines ----------------
     // Engine A baseline (default)
@@ -968,6 +1283,12 @@ int main() {
         tc.hillClimbEvals = 18;
         tc.steps = { 25, 15, 10, 5 };
         tc.minPointGainToAccept = 2.0;
+        tc.workers = kMatchWorkers;
+        tc.sprt.enabled = false; // opt-in: candidates vs current best, accepted on H1 (see PieceTuningConfig)
+        tc.sprt.elo0 = 0.0;
+        tc.sprt.elo1 = 10.0;
+        tc.sprt.alpha = 0.05;
+        tc.sprt.beta = 0.05;
 
         PieceValues best = tunePieceValuesVsBaseline(fens, cfgA, tc);
 
@@ -989,6 +1310,7 @@ int main() {
     rcfg.totalGamesWanted = 200; // total games
     rcfg.useUI = kShowUIInMatch;
     rcfg.verbose = true;
+    rcfg.workers = kMatchWorkers;
 
     MatchResultAB r = runABMatchSeries(fens, cfgA, cfgB, rcfg);
 
@@ -86,9 +86,10 @@ void displayEndGameMessage(sf::RenderWindow& window, const std::string& message)
 }
 
 void playAgainstComputer() {
-    // NOTE: engine.cpp (Engine) doesn’t use your old engine2 pondering globals/threads.
-    // This keeps the UI toggle, but it is currently cosmetic (no background search).
+    // Pondering: while the player thinks, the engine searches the reply it expects (PV[1]).
     bool ponderingOn = false;
+    bool ponderActive = false;
+    Move expectedReply = NO_MOVE;
 
     int timeLimit = 3000; // milliseconds
     char playerColor = 'w';
@@ -275,8 +276,27 @@ void playAgainstComputer() {
                         return;
                     }
 
-                    engine.setTimeLimitMs(timeLimit);
-                    Move engineMove = engine.getMove(board);
+                    Move engineMove = NO_MOVE;
+                    bool ponderHit = false;
+
+                    if (ponderActive) {
+                        ponderActive = false;
+                        if (board.lastMove == expectedReply) {
+                            // hit: the background search becomes the real one, with a fresh move budget
+                            engine.ponderhit();
+                            engineMove = engine.wait();
+                            ponderHit = true;
+                        } else {
+                            // miss: abort and search the actual position
+                            engine.stop();
+                            engine.wait();
+                        }
+                    }
+
+                    if (!ponderHit) {
+                        engine.setTimeLimitMs(timeLimit);
+                        engineMove = engine.getMove(board);
+                    }
 
                     Undo u;
                     board.makeMove(engineMove, u);
@@ -288,7 +308,19 @@ void playAgainstComputer() {
 
                     isPlayerTurn = true;
 
-                    (void)ponderingOn;
+                    if (ponderingOn) {
+                        expectedReply = engine.ponderMove();
+                        if (expectedReply != NO_MOVE) {
+                            Board ponderBoard = board;
+                            Undo pu;
+                            ponderBoard.makeMove(expectedReply, pu);
+
+                            SearchLimits ponderLimits;
+                            ponderLimits.ponder = true;
+                            engine.startSearch(ponderBoard, ponderLimits);
+                            ponderActive = true;
+                        }
+                    }
                 }
 
                 window.clear();
@@ -0,0 +1,261 @@
+#include "chess.h"
+#include "engine.h"
+#include "test_corpus.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------
+// Microbenchmarks for the search hot paths, over a fixed corpus:
+// positions.txt + the PerftSuite FENs.
+//
+//   microbench [positions.txt] [--reps N] [--warmup-ms N] [--json [file]]
+//
+// Each benchmark runs warmup passes (also used to size a repetition to ~20 ms),
+// then N timed repetitions; ns/op is reported as mean, stddev, min and median.
+// ------------------------------------------------------------
+
+// results are folded in here so the optimizer cannot drop the work
+static volatile uint64_t g_sink = 0;
+
+struct CorpusEntry {
+    Board board;
+    MoveList moves;        // legal moves
+    MoveList captures;     // legal captures
+};
+
+struct BenchStats {
+    std::string name;
+    uint64_t opsPerRep = 0;
+    int reps = 0;
+    double meanNs = 0, stddevNs = 0, minNs = 0, medianNs = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// pass() runs the operation over the whole corpus once and returns how many ops it did
+static BenchStats measure(const std::string& name, const std::function<uint64_t()>& pass, int reps, int warmupMs) {
+    // warmup + calibration: how many passes make a ~20 ms repetition
+    uint64_t passes = 0;
+    const auto w0 = Clock::now();
+    while (std::chrono::duration<double, std::milli>(Clock::now() - w0).count() < warmupMs) {
+        pass();
+        passes++;
+    }
+    const double warmMs = std::chrono::duration<double, std::milli>(Clock::now() - w0).count();
+    const uint64_t passesPerRep = std::max<uint64_t>(1, (uint64_t)(passes * 20.0 / std::max(1.0, warmMs)));
+
+    std::vector<double> samples;
+    samples.reserve(reps);
+    uint64_t ops = 0;
+
+    for (int r = 0; r < reps; ++r) {
+        ops = 0;
+        const auto t0 = Clock::now();
+        for (uint64_t p = 0; p < passesPerRep; ++p) ops += pass();
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        samples.push_back(ns / (double)std::max<uint64_t>(1, ops));
+    }
+
+    BenchStats s;
+    s.name = name;
+    s.opsPerRep = ops;
+    s.reps = reps;
+
+    double sum = 0;
+    for (double x : samples) sum += x;
+    s.meanNs = sum / samples.size();
+
+    double var = 0;
+    for (double x : samples) var += (x - s.meanNs) * (x - s.meanNs);
+    s.stddevNs = samples.size() > 1 ? std::sqrt(var / (samples.size() - 1)) : 0.0;
+
+    std::sort(samples.begin(), samples.end());
+    s.minNs = samples.front();
+    s.medianNs = samples[samples.size() / 2];
+    return s;
+}
+
+static std::vector<CorpusEntry> loadCorpus(const std::string& path) {
+    const std::vector<std::string> fens = loadTestCorpus(path);
+
+    std::vector<CorpusEntry> corpus;
+    corpus.reserve(fens.size());
+    for (const std::string& fen : fens) {
+        CorpusEntry e;
+        e.board.createBoardFromFEN(fen);
+        e.board.generateAllMoves(e.moves);
+        for (const Move& m : e.moves) {
+            if (m.isCapture) e.captures.push(m);
+        }
+        corpus.push_back(std::move(e));
+    }
+    return corpus;
+}
+
+static void printTable(const std::vector<BenchStats>& results) {
+    std::cout << std::left << std::setw(22) << "benchmark"
+              << std::right << std::setw(12) << "ns/op" << std::setw(10) << "stddev"
+              << std::setw(10) << "min" << std::setw(10) << "median" << std::setw(12) << "ops/rep" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const BenchStats& s : results) {
+        std::cout << std::left << std::setw(22) << s.name
+                  << std::right << std::setw(12) << s.meanNs << std::setw(10) << s.stddevNs
+                  << std::setw(10) << s.minNs << std::setw(10) << s.medianNs << std::setw(12) << s.opsPerRep << "\n";
+    }
+}
+
+static void writeJson(std::ostream& os, const std::vector<BenchStats>& results, size_t corpusSize) {
+    os << std::fixed << std::setprecision(3);
+    os << "{\n  \"corpus_positions\": " << corpusSize << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchStats& s = results[i];
+        os << "    {\"name\": \"" << s.name << "\", \"ns_per_op\": " << s.meanNs
+           << ", \"stddev_ns\": " << s.stddevNs << ", \"min_ns\": " << s.minNs
+           << ", \"median_ns\": " << s.medianNs << ", \"reps\": " << s.reps
+           << ", \"ops_per_rep\": " << s.opsPerRep << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    std::string positionsPath = "positions.txt";
+    int reps = 10;
+    int warmupMs = 100;
+    bool json = false;
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--reps" && i + 1 < argc)           reps = std::max(2, std::atoi(argv[++i]));
+        else if (a == "--warmup-ms" && i + 1 < argc) warmupMs = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--json") {
+            json = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') jsonPath = argv[++i];
+        }
+        else positionsPath = a;
+    }
+
+    std::vector<CorpusEntry> corpus = loadCorpus(positionsPath);
+    Engine engine;
+
+    std::vector<BenchStats> results;
+
+    results.push_back(measure("generateAllMoves", [&] {
+        uint64_t n = 0;
+        for (CorpusEntry& e : corpus) {
+            MoveList ml;
+            e.board.generateAllMoves(ml);
+            g_sink = g_sink + ml.size;
+            n++;
+        }
+        return n;
+    }, reps, warmupMs));
+
+    results.push_back(measure("makeMove+undoMove", [&] {
+        uint64_t n = 0;
+        for (CorpusEntry& e : corpus) {
+            for (int i = 0; i < e.moves.size; ++i) {
+                Move m = e.moves.m[i];
+                Undo u;
+                e.board.makeMove(m, u);
+                g_sink = g_sink + e.board.zobristHash;
+                e.board.undoMove(m, u);
+                n++;
+            }
+        }
+        return n;
+    }, reps, warmupMs));
+
+    results.push_back(measure("amIInCheck", [&] {
+        uint64_t n = 0;
+        for (CorpusEntry& e : corpus) {
+            g_sink = g_sink + e.board.amIInCheck(e.board.whiteToMove);
+            n++;
+        }
+        return n;
+    }, reps, warmupMs));
+
+    results.push_back(measure("computePinnedMask", [&] {
+        uint64_t n = 0;
+        for (CorpusEntry& e : corpus) {
+            g_sink = g_sink + e.board.computePinnedMask(e.board.whiteToMove);
+            n++;
+        }
+        return n;
+    }, reps, warmupMs));
+
+    results.push_back(measure("rookAttacks", [&] {
+        uint64_t n = 0;
+        for (CorpusEntry& e : corpus) {
+            const Bitboard occ = e.board.whitePieces | e.board.blackPieces;
+            for (int sq = 0; sq < 64; ++sq) g_sink = g_sink + rookAttacks(sq, occ);
+            n += 64;
+        }
+        return n;
+    }, reps, warmupMs));
+
+    results.push_back(measure("bishopAttacks", [&] {
+        uint64_t n = 0;
+        for (CorpusEntry& e : corpus) {
+            const Bitboard occ = e.board.whitePieces | e.board.blackPieces;
+            for (int sq = 0; sq < 64; ++sq) g_sink = g_sink + bishopAttacks(sq, occ);
+            n += 64;
+        }
+        return n;
+    }, reps, warmupMs));
+
+    results.push_back(measure("isGoodCapture", [&] {
+        uint64_t n = 0;
+        for (CorpusEntry& e : corpus) {
+            for (int i = 0; i < e.captures.size; ++i) {
+                g_sink = g_sink + (uint64_t)isGoodCapture(e.captures.m[i], e.board);
+                n++;
+            }
+        }
+        return n;
+    }, reps, warmupMs));
+
+    results.push_back(measure("generateZobristHash", [&] {
+        uint64_t n = 0;
+        for (CorpusEntry& e : corpus) {
+            g_sink = g_sink + e.board.generateZobristHash();
+            n++;
+        }
+        return n;
+    }, reps, warmupMs));
+
+    results.push_back(measure("evaluate", [&] {
+        uint64_t n = 0;
+        for (CorpusEntry& e : corpus) {
+            g_sink = g_sink + (uint64_t)engine.staticEval(e.board);
+            n++;
+        }
+        return n;
+    }, reps, warmupMs));
+
+    if (json && jsonPath.empty()) {
+        writeJson(std::cout, results, corpus.size());
+        return 0;
+    }
+
+    std::cout << "corpus: " << corpus.size() << " positions, " << reps << " reps\n";
+    printTable(results);
+
+    if (json) {
+        std::ofstream out(jsonPath);
+        writeJson(out, results, corpus.size());
+        std::cout << "wrote " << jsonPath << "\n";
+    }
+    return 0;
+}
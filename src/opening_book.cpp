@@ -58,3 +58,9 @@ bool OpeningBook::probe(uint64_t zobrist, Move& outMove) const {
     }
     return false;
 }
+
+std::shared_ptr<const OpeningBook> loadOpeningBook(const char* path) {
+    auto book = std::make_shared<OpeningBook>();
+    book->load(path);
+    return book;
+}
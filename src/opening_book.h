@@ -1,5 +1,6 @@
 #pragma once
 #include "chess.h"
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -16,3 +17,6 @@ public:
 private:
     std::unordered_map<uint64_t, std::vector<BookMove>> book_;
 };
+
+// Loads a book once for sharing between engines; a missing file gives an empty book.
+std::shared_ptr<const OpeningBook> loadOpeningBook(const char* path);
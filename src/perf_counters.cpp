@@ -0,0 +1,131 @@
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* const PERF_EVENT_NAMES[PERF_EVENT_COUNT] = {
+    "cycles", "instructions", "L1d misses", "LLC misses", "branch misses",
+};
+
+#ifdef __linux__
+
+static uint64_t cacheMissConfig(uint64_t cache) {
+    return cache | ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8) | ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+static int openEvent(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;   // include threads started while counting (parallel perft workers)
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // this thread (and its children), any CPU
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+PerfCounters::PerfCounters() {
+    const struct { uint32_t type; uint64_t config; } events[PERF_EVENT_COUNT] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_L1D) },
+        { PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_LL) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    int firstErrno = 0;
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i) {
+        fd_[i] = openEvent(events[i].type, events[i].config);
+        if (fd_[i] >= 0) available_ = true;
+        else if (!firstErrno) firstErrno = errno;
+    }
+
+    if (!available_) {
+        reason_ = std::string("perf_event_open failed: ") + std::strerror(firstErrno);
+        if (firstErrno == EACCES || firstErrno == EPERM) reason_ += " (check /proc/sys/kernel/perf_event_paranoid)";
+        else if (firstErrno == ENOENT || firstErrno == ENODEV || firstErrno == EOPNOTSUPP) reason_ += " (no hardware PMU exposed)";
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fd_) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+void PerfCounters::start() {
+    for (int fd : fd_) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+PerfSample PerfCounters::stop() {
+    for (int fd : fd_) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    PerfSample s;
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i) {
+        if (fd_[i] < 0) continue;
+
+        uint64_t buf[3] = {}; // value, time enabled, time running
+        if (read(fd_[i], buf, sizeof(buf)) != (ssize_t)sizeof(buf) || buf[2] == 0) continue;
+
+        // more events than hardware counters: the kernel time-slices them, so extrapolate
+        s.value[i] = (buf[2] < buf[1]) ? (uint64_t)((double)buf[0] * (double)buf[1] / (double)buf[2]) : buf[0];
+        s.valid[i] = true;
+    }
+    return s;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    for (int& fd : fd_) fd = -1;
+    reason_ = "hardware counters are only supported on Linux";
+}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+
+PerfSample PerfCounters::stop() { return PerfSample{}; }
+
+#endif
+
+void printPerfSample(std::ostream& os, const PerfSample& s, uint64_t nodes) {
+    const double n = (double)(nodes ? nodes : 1);
+    const std::ios_base::fmtflags flags = os.flags();
+    const std::streamsize prec = os.precision();
+
+    os << std::fixed << std::setprecision(2);
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i) {
+        os << "  " << std::left << std::setw(14) << PERF_EVENT_NAMES[i] << std::right;
+        if (!s.valid[i]) {
+            os << std::setw(16) << "n/a" << "\n";
+            continue;
+        }
+        os << std::setw(16) << s.value[i] << "  " << std::setw(10) << (double)s.value[i] / n << " /node\n";
+    }
+    if (s.valid[PERF_CYCLES] && s.valid[PERF_INSTRUCTIONS] && s.value[PERF_CYCLES]) {
+        os << "  IPC           " << std::setw(16) << (double)s.value[PERF_INSTRUCTIONS] / (double)s.value[PERF_CYCLES] << "\n";
+    }
+
+    os.flags(flags);
+    os.precision(prec);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Hardware performance counters (Linux perf_event_open) for the calling thread and the threads it
+// starts while counting, user space only.
+// Each event is opened on its own, so a PMU that lacks e.g. LLC events still reports the rest;
+// on other platforms, or when the kernel refuses (perf_event_paranoid, containers, VMs without a
+// virtual PMU), available() is false and every reading is zero.
+enum PerfEvent {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_EVENT_COUNT
+};
+
+struct PerfSample {
+    uint64_t value[PERF_EVENT_COUNT] = {};
+    bool     valid[PERF_EVENT_COUNT] = {};
+
+    bool any() const {
+        for (bool v : valid) if (v) return true;
+        return false;
+    }
+};
+
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return available_; }
+    const std::string& unavailableReason() const { return reason_; }
+
+    void start();           // reset and enable all open events
+    PerfSample stop();      // disable and read (scaled if the kernel multiplexed the events)
+
+private:
+    int fd_[PERF_EVENT_COUNT];
+    bool available_ = false;
+    std::string reason_;
+};
+
+// One line per event, normalised per node ("nodes" = perft leaves or search nodes).
+void printPerfSample(std::ostream& os, const PerfSample& s, uint64_t nodes);
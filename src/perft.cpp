@@ -0,0 +1,219 @@
+#include "perft.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+PerftTable::PerftTable(size_t mb) {
+    size_t n = 1;
+    const size_t bytes = std::max<size_t>(1, mb) * 1024 * 1024;
+    while (n * 2 * sizeof(Entry) <= bytes) n *= 2;
+    table_ = std::vector<Entry>(n);
+    mask_ = (uint64_t)(n - 1);
+}
+
+size_t PerftTable::index(uint64_t key, int depth) const {
+    // mix the depth in so the same position at different depths uses different slots
+    return (size_t)((key ^ ((uint64_t)depth * 0x9E3779B97F4A7C15ULL)) & mask_);
+}
+
+bool PerftTable::probe(uint64_t key, int depth, PerftCounts& out) const {
+    const Entry& e = table_[index(key, depth)];
+    const uint64_t check = e.check.load(std::memory_order_relaxed);
+    const uint64_t d     = e.depth.load(std::memory_order_relaxed);
+    PerftCounts c;
+    c.nodes    = e.nodes.load(std::memory_order_relaxed);
+    c.captures = e.captures.load(std::memory_order_relaxed);
+    c.checks   = e.checks.load(std::memory_order_relaxed);
+    c.mates    = e.mates.load(std::memory_order_relaxed);
+
+    if (d != (uint64_t)depth || c.nodes == 0) return false;
+    if ((check ^ d ^ c.nodes ^ c.captures ^ c.checks ^ c.mates) != key) return false;
+    out = c;
+    return true;
+}
+
+void PerftTable::store(uint64_t key, int depth, const PerftCounts& c) {
+    Entry& e = table_[index(key, depth)];
+    e.check.store(key ^ (uint64_t)depth ^ c.nodes ^ c.captures ^ c.checks ^ c.mates, std::memory_order_relaxed);
+    e.depth.store((uint64_t)depth, std::memory_order_relaxed);
+    e.nodes.store(c.nodes, std::memory_order_relaxed);
+    e.captures.store(c.captures, std::memory_order_relaxed);
+    e.checks.store(c.checks, std::memory_order_relaxed);
+    e.mates.store(c.mates, std::memory_order_relaxed);
+}
+
+PerftCounts perft(Board& board, int depth, PerftTable* table) {
+    PerftCounts out{};
+    if (depth == 0) { out.nodes = 1; return out; }
+
+    // depth 1 is just a move generation: cheaper to redo than to look up
+    const bool hashed = table && depth >= 2;
+    if (hashed && table->probe(board.zobristHash, depth, out)) return out;
+
+    MoveList moves;
+    board.generateAllMoves(moves);
+
+    for (auto& m : moves) {
+        Undo u;
+        board.makeMove(m, u);
+
+        if (depth == 1) {
+            out.nodes += 1;
+            if (m.isCapture) out.captures += 1;
+
+            // leaf: side-to-move is in check; mate if it also has no legal reply
+            if (board.amIInCheck(board.whiteToMove)) {
+                out.checks += 1;
+                MoveList tmp;
+                board.generateAllMoves(tmp);
+                if (tmp.size == 0) out.mates += 1;
+            }
+        } else {
+            out += perft(board, depth - 1, table);
+        }
+        board.undoMove(m, u);
+    }
+
+    if (hashed) table->store(board.zobristHash, depth, out);
+    return out;
+}
+
+// Nodes-only entries live in the same table as full ones; salting the key keeps a nodes-only
+// entry (captures/checks/mates left at zero) from ever answering a full-stats probe.
+static constexpr uint64_t NODES_ONLY_SALT = 0xA5F0C3E1B2D49687ULL;
+
+uint64_t perftNodes(Board& board, int depth, PerftTable* table) {
+    if (depth == 0) return 1;
+
+    // probe before generating, so a hit costs no move generation
+    const uint64_t key = board.zobristHash ^ NODES_ONLY_SALT;
+    const bool hashed = table && depth >= 2;
+    PerftCounts cached;
+    if (hashed && table->probe(key, depth, cached)) return cached.nodes;
+
+    MoveList moves;
+    board.generateAllMoves(moves);
+    if (depth == 1) return (uint64_t)moves.size; // bulk count: the generator is fully legal
+
+    uint64_t nodes = 0;
+    for (auto& m : moves) {
+        Undo u;
+        board.makeMove(m, u);
+        nodes += perftNodes(board, depth - 1, table);
+        board.undoMove(m, u);
+    }
+
+    if (hashed) {
+        PerftCounts c;
+        c.nodes = nodes;
+        table->store(key, depth, c);
+    }
+    return nodes;
+}
+
+int perftDefaultThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+namespace {
+
+// A subtree: the moves leading to it from the root, and the depth left to search below it.
+struct PerftTask {
+    std::vector<Move> path;
+    int depth = 0;
+};
+
+// Expands every task by one ply. Tasks whose position has no moves drop out: with depth >= 1
+// left they contain no leaves.
+std::vector<PerftTask> expand(const Board& root, const std::vector<PerftTask>& tasks) {
+    std::vector<PerftTask> out;
+    for (const PerftTask& t : tasks) {
+        Board b = root;
+        std::vector<Undo> undo(t.path.size());
+        for (size_t i = 0; i < t.path.size(); ++i) {
+            Move m = t.path[i];
+            b.makeMove(m, undo[i]);
+        }
+
+        MoveList moves;
+        b.generateAllMoves(moves);
+        for (const Move& m : moves) {
+            PerftTask child;
+            child.path = t.path;
+            child.path.push_back(m);
+            child.depth = t.depth - 1;
+            out.push_back(std::move(child));
+        }
+    }
+    return out;
+}
+
+// Runs countTask(board, depth) over the subtrees on `threads` workers and sums the results.
+template <class CountFn>
+PerftCounts runSplit(const Board& board, int depth, int threads, const CountFn& countTask) {
+    // Split until there are plenty of subtrees per worker (subtree sizes vary a lot, so
+    // many small tasks balance better than one per thread). Leaf counting needs the last
+    // move to be made inside the task, so every task keeps depth >= 1.
+    const size_t wanted = (size_t)threads * 16;
+    std::vector<PerftTask> tasks(1);
+    tasks[0].depth = depth;
+    while (tasks.size() < wanted && tasks[0].depth > 1) {
+        tasks = expand(board, tasks);
+        if (tasks.empty()) return PerftCounts{};
+    }
+
+    // whichever worker is free claims the next task from the shared cursor
+    std::atomic<size_t> next{ 0 };
+    std::vector<PerftCounts> partial(threads);
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+
+    for (int w = 0; w < threads; ++w) {
+        pool.emplace_back([&, w] {
+            PerftCounts local{};
+            for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < tasks.size();
+                 i = next.fetch_add(1, std::memory_order_relaxed)) {
+                const PerftTask& t = tasks[i];
+                Board b = board;
+                for (const Move& pm : t.path) {
+                    Move m = pm;
+                    Undo u;
+                    b.makeMove(m, u);
+                }
+                local += countTask(b, t.depth);
+            }
+            partial[w] = local;
+        });
+    }
+    for (std::thread& t : pool) t.join();
+
+    PerftCounts total{};
+    for (const PerftCounts& p : partial) total += p;
+    return total;
+}
+
+} // namespace
+
+PerftCounts perftParallel(const Board& board, int depth, int threads, PerftTable* table) {
+    if (threads <= 0) threads = perftDefaultThreads();
+    if (threads == 1 || depth <= 1) {
+        Board b = board;
+        return perft(b, depth, table);
+    }
+    return runSplit(board, depth, threads, [table](Board& b, int d) { return perft(b, d, table); });
+}
+
+uint64_t perftNodesParallel(const Board& board, int depth, int threads, PerftTable* table) {
+    if (threads <= 0) threads = perftDefaultThreads();
+    if (threads == 1 || depth <= 1) {
+        Board b = board;
+        return perftNodes(b, depth, table);
+    }
+    return runSplit(board, depth, threads, [table](Board& b, int d) {
+        PerftCounts c;
+        c.nodes = perftNodes(b, d, table);
+        return c;
+    }).nodes;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "chess.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Perft with the leaf statistics the suites check: captures, checks and mates are
+// counted at the leaves (side to move in check / checkmated after the last move).
+struct PerftCounts {
+    uint64_t nodes    = 0;
+    uint64_t captures = 0;
+    uint64_t checks   = 0;
+    uint64_t mates    = 0;
+
+    PerftCounts& operator+=(const PerftCounts& o) {
+        nodes    += o.nodes;
+        captures += o.captures;
+        checks   += o.checks;
+        mates    += o.mates;
+        return *this;
+    }
+};
+
+// Transposition table for perft: (zobristHash, remaining depth) -> PerftCounts.
+// Lockless, so one table can be shared by all perftParallel workers: every field is a relaxed
+// atomic and the entry carries key ^ (all data words), so a read racing a write (torn entry)
+// fails the check and is treated as a miss. Always-replace.
+class PerftTable {
+public:
+    explicit PerftTable(size_t mb);
+
+    bool probe(uint64_t key, int depth, PerftCounts& out) const;
+    void store(uint64_t key, int depth, const PerftCounts& c);
+
+    size_t entries() const { return table_.size(); }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check{ 0 };   // key ^ depth ^ nodes ^ captures ^ checks ^ mates
+        std::atomic<uint64_t> depth{ 0 };
+        std::atomic<uint64_t> nodes{ 0 };
+        std::atomic<uint64_t> captures{ 0 };
+        std::atomic<uint64_t> checks{ 0 };
+        std::atomic<uint64_t> mates{ 0 };
+    };
+
+    size_t index(uint64_t key, int depth) const;
+
+    std::vector<Entry> table_;
+    uint64_t mask_ = 0;
+};
+
+// table may be null (plain perft). Positions with depth >= 2 left are looked up / stored.
+PerftCounts perft(Board& board, int depth, PerftTable* table = nullptr);
+
+// Leaf count only, with bulk counting at the horizon: at depth 1 the legal move list size is
+// the answer, so the last ply is never made/unmade. Much faster when only the totals are checked.
+// Shares PerftTable with perft() (the entries are kept apart).
+uint64_t perftNodes(Board& board, int depth, PerftTable* table = nullptr);
+
+// Same counts, computed on `threads` workers (0 = one per hardware thread).
+// The tree is split at the root, and a few plies deeper while there are too few subtrees
+// to keep every worker busy; workers pull subtrees from a shared queue, each replaying
+// the moves on its own Board copy, and the per-worker totals are summed at the end.
+PerftCounts perftParallel(const Board& board, int depth, int threads, PerftTable* table = nullptr);
+
+uint64_t perftNodesParallel(const Board& board, int depth, int threads, PerftTable* table = nullptr);
+
+int perftDefaultThreads();
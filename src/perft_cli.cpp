@@ -1,9 +1,12 @@
 #include "chess.h"
+#include "perf_counters.h"
+#include "perft.h"
 
 #include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -22,79 +25,13 @@ static std::string indexToCoord(int sq) {
     return std::string() + fileChar + rankChar;
 }
 
-static std::string moveToUCI(const Move& m) {
-    std::string s = indexToCoord(m.from) + indexToCoord(m.to);
-    if (m.promotion) {
-        char p = m.promotion;
-        if (p >= 'A' && p <= 'Z') p = char(p - 'A' + 'a');
-        s.push_back(p);
-    }
-    return s;
-}
-
 static bool applyUCIMove(Board& board, const std::string& uci) {
-    if (uci.size() < 4) return false;
+    Move m;
+    if (!parseUCIMove(board, uci, m)) return false; // illegal move
 
-    // Generate legal moves in the current position
-    MoveList moves;
-    board.generateAllMoves(moves);
-
-    for (Move& m : moves) {
-        if (moveToUCI(m) == uci) {
-            Undo u;
-            board.makeMove(m, u);
-            return true;
-        }
-    }
-    return false; // illegal move
-}
-
-// ------------------------------------------------------------
-// Perft counts
-// ------------------------------------------------------------
-struct PerftCounts {
-    uint64_t nodes    = 0;
-    uint64_t captures = 0;
-    uint64_t checks   = 0;
-    uint64_t mates    = 0;
-};
-
-static PerftCounts perft(Board& board, int depth) {
-    PerftCounts out{};
-    if (depth == 0) { out.nodes = 1; return out; }
-
-    MoveList moves;
-    board.generateAllMoves(moves);
-
-    for (auto& m : moves) {
-        Undo u;
-        board.makeMove(m, u);
-
-        if (depth == 1) {
-            out.nodes += 1;
-
-            if (m.isCapture) out.captures += 1;
-
-            // suites count check if side-to-move is in check at leaf
-            if (board.amIInCheck(board.whiteToMove)) {
-                out.checks += 1;
-                MoveList tmp; 
-                board.generateAllMoves(tmp);
-                if (tmp.size == 0) {
-                    out.mates += 1;
-                }
-            }
-        } else {
-            PerftCounts child = perft(board, depth - 1);
-            out.nodes    += child.nodes;
-            out.captures += child.captures;
-            out.checks   += child.checks;
-            out.mates    += child.mates;
-        }
-        board.undoMove(m, u);
-    }
-
-    return out;
+    Undo u;
+    board.makeMove(m, u);
+    return true;
 }
 
 // ------------------------------------------------------------
@@ -163,7 +100,7 @@ struct DivideLine {
     std::tuple<int,int,int,int,int,int,int> key;
 };
 
-static std::vector<DivideLine> divide(Board& board, int depth) {
+static std::vector<DivideLine> divide(Board& board, int depth, int threads, PerftTable* table) {
     std::vector<DivideLine> out;
     MoveList moves;
     board.generateAllMoves(moves);
@@ -175,7 +112,7 @@ static std::vector<DivideLine> divide(Board& board, int depth) {
         ln.key = stockfishLikeKey(board, m);
         Undo u;
         board.makeMove(m, u);
-        ln.nodes = (depth <= 1) ? 1 : perft(board, depth - 1).nodes;
+        ln.nodes = (depth <= 1) ? 1 : perftNodesParallel(board, depth - 1, threads, table);
         board.undoMove(m, u);
 
         out.push_back(std::move(ln));
@@ -189,6 +126,26 @@ static std::vector<DivideLine> divide(Board& board, int depth) {
     return out;
 }
 
+// Trailing perft/divide options: "nodes" (bulk-counting, nodes only) and "hash <MB>" (a fresh perft TT)
+struct PerftOptions {
+    bool nodesOnly = false;
+    std::unique_ptr<PerftTable> table;
+};
+
+static PerftOptions parsePerftOptions(std::istringstream& iss) {
+    PerftOptions opt;
+    for (std::string token; iss >> token; ) {
+        if (token == "nodes") {
+            opt.nodesOnly = true;
+        }
+        else if (token == "hash") {
+            size_t mb = 0;
+            if (iss >> mb && mb > 0) opt.table = std::make_unique<PerftTable>(mb);
+        }
+    }
+    return opt;
+}
+
 // ------------------------------------------------------------
 // Simple Stockfish-ish CLI
 // ------------------------------------------------------------
@@ -197,8 +154,11 @@ static void print_help() {
         "Commands:\n"
         "  position startpos\n"
         "  position fen <FEN...>\n"
-        "  perft <N>\n"
-        "  divide <N>\n"
+        "  perft <N> [nodes] [hash <MB>]   (nodes: bulk-counted total only)\n"
+        "  divide <N> [hash <MB>]\n"
+        "  threads <N>    (perft/divide worker threads)\n"
+        "  scaling <N>    (perft N at 1, 2, 4, ... threads: NPS and speedup)\n"
+        "  counters on|off (hardware counters per node around perft/divide, Linux only)\n"
         "  d              (prints board + fen)\n"
         "  help\n"
         "  quit\n";
@@ -207,6 +167,8 @@ static void print_help() {
 int main() {
     Board board; // creates start position by default
     std::string currentFEN = "startpos";
+    std::unique_ptr<PerfCounters> hw; // set while "counters on"
+    int threads = perftDefaultThreads();
 
     std::cout << "ChessEngine perft CLI (Stockfish-style)\n";
     print_help();
@@ -226,6 +188,63 @@ int main() {
             continue;
         }
 
+        if (cmd == "threads") {
+            int n = 0;
+            iss >> n;
+            if (n < 1) {
+                std::cout << "error: threads must be >= 1\n";
+                continue;
+            }
+            threads = n;
+            std::cout << "threads " << threads << "\n";
+            continue;
+        }
+
+        if (cmd == "scaling") {
+            int depth = 0;
+            iss >> depth;
+            if (depth <= 0) {
+                std::cout << "error: depth must be >= 1\n";
+                continue;
+            }
+
+            double baseNps = 0.0;
+            for (int t = 1; ; t = std::min(t * 2, threads)) {
+                auto t0 = std::chrono::high_resolution_clock::now();
+                PerftCounts r = perftParallel(board, depth, t);
+                auto t1 = std::chrono::high_resolution_clock::now();
+                double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+                double nps = (double)r.nodes * 1000.0 / std::max(ms, 0.001);
+                if (t == 1) baseNps = nps;
+
+                std::cout << "Threads: " << t
+                          << "  Nodes: " << r.nodes
+                          << "  Time: " << ms << " ms"
+                          << "  NPS: " << (uint64_t)nps
+                          << "  Speedup: " << nps / std::max(baseNps, 1.0) << "x\n";
+                if (t == threads) break;
+            }
+            continue;
+        }
+
+        if (cmd == "counters") {
+            std::string arg;
+            iss >> arg;
+            if (arg == "off") {
+                hw.reset();
+                std::cout << "counters off\n";
+                continue;
+            }
+            hw = std::make_unique<PerfCounters>();
+            if (!hw->available()) {
+                std::cout << "counters unavailable: " << hw->unavailableReason() << "\n";
+                hw.reset();
+                continue;
+            }
+            std::cout << "counters on\n";
+            continue;
+        }
+
         if (cmd == "d") {
             board.printBoard();
             continue;
@@ -298,17 +317,28 @@ int main() {
                 continue;
             }
 
+            const PerftOptions opt = parsePerftOptions(iss);
+
             Board b = board; // run on a copy so CLI state stays unchanged
+            if (hw) hw->start();
             auto t0 = std::chrono::high_resolution_clock::now();
-            PerftCounts r = perft(b, depth);
+            PerftCounts r;
+            if (opt.nodesOnly) r.nodes = perftNodesParallel(b, depth, threads, opt.table.get());
+            else               r = perftParallel(b, depth, threads, opt.table.get());
             auto t1 = std::chrono::high_resolution_clock::now();
+            const PerfSample hwSample = hw ? hw->stop() : PerfSample{};
             double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
 
-            std::cout << "Nodes: " << r.nodes
-                      << "  Captures: " << r.captures
-                      << "  Checks: " << r.checks
-                      << "  Mates: " << r.mates
-                      << "  Time: " << ms << " ms\n";
+            std::cout << "Nodes: " << r.nodes;
+            if (!opt.nodesOnly) {
+                std::cout << "  Captures: " << r.captures
+                          << "  Checks: " << r.checks
+                          << "  Mates: " << r.mates;
+            }
+            std::cout << "  Time: " << ms << " ms"
+                      << "  NPS: " << (uint64_t)((double)r.nodes * 1000.0 / std::max(ms, 0.001))
+                      << "  Threads: " << threads << "\n";
+            if (hw) printPerfSample(std::cout, hwSample, r.nodes);
             continue;
         }
 
@@ -320,10 +350,14 @@ int main() {
                 continue;
             }
 
+            const PerftOptions opt = parsePerftOptions(iss);
+
             Board b = board; // copy
+            if (hw) hw->start();
             auto t0 = std::chrono::high_resolution_clock::now();
-            auto lines = divide(b, depth);
+            auto lines = divide(b, depth, threads, opt.table.get());
             auto t1 = std::chrono::high_resolution_clock::now();
+            const PerfSample hwSample = hw ? hw->stop() : PerfSample{};
 
             uint64_t total = 0;
             for (auto& ln : lines) {
@@ -332,6 +366,7 @@ int main() {
             }
             double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
             std::cout << "Total: " << total << "  Time: " << ms << " ms\n";
+            if (hw) printPerfSample(std::cout, hwSample, total);
             continue;
         }
 
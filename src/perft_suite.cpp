@@ -1,12 +1,21 @@
 #include "chess.h"
+#include "perft.h"
+#include "test_corpus.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -43,60 +52,6 @@ namespace ansi {
     }
 }
 
-// -----------------------------
-// Perft counts (only what you want)
-// -----------------------------
-struct PerftCounts {
-    uint64_t nodes    = 0;
-    uint64_t captures = 0;
-    uint64_t checks   = 0;
-    uint64_t mates    = 0;
-};
-
-// Leaf checks/mates logic as discussed
-static PerftCounts perft(Board& board, int depth) {
-    PerftCounts out{};
-
-    if (depth == 0) {
-        out.nodes = 1;
-        return out;
-    }
-    MoveList moves;
-    board.generateAllMoves(moves);
-
-    for (auto& m : moves) {
-        Undo u;
-        board.makeMove(m, u);
-
-        if (depth == 1) {
-            out.nodes += 1;
-            if (m.isCapture) out.captures += 1;
-
-            // Leaf: side-to-move is in check
-            if (board.amIInCheck(board.whiteToMove)) {
-                out.checks += 1;
-
-                // Leaf mate: in check and no legal replies
-                MoveList tmp;
-                board.generateAllMoves(tmp);
-                if (tmp.size == 0) {
-                    out.mates += 1;
-                }
-            }
-        } else {
-            PerftCounts child = perft(board, depth - 1);
-            out.nodes    += child.nodes;
-            out.captures += child.captures;
-            out.checks   += child.checks;
-            out.mates    += child.mates;
-        }
-
-        board.undoMove(m, u);
-    }
-
-    return out;
-}
-
 // -----------------------------
 // Move formatting using YOUR board mapping
 // -----------------------------
@@ -113,16 +68,6 @@ static std::string indexToCoord(int sq) {
     return std::string() + fileChar + rankChar;
 }
 
-static std::string moveToUCI(const Move& m) {
-    std::string s = indexToCoord(m.from) + indexToCoord(m.to);
-    if (m.promotion) {
-        char p = m.promotion;
-        if (p >= 'A' && p <= 'Z') p = char(p - 'A' + 'a');
-        s.push_back(p);
-    }
-    return s;
-}
-
 // -----------------------------
 // Stockfish-like divide ordering
 // -----------------------------
@@ -229,7 +174,7 @@ static std::vector<DivideLine> perftDivideNodesStockfishOrder(Board& board, int
         board.makeMove(m, u);
 
         if (depth <= 1) line.nodes = 1;
-        else line.nodes = perft(board, depth - 1).nodes;
+        else line.nodes = perftNodes(board, depth - 1);
 
         board.undoMove(m, u);
 
@@ -309,7 +254,10 @@ static void printDivideDebug(const PerftPositionSuite& suite, int depth) {
     std::cout << ansi::grey << "  TOTAL: " << total << ansi::reset << "\n";
 }
 
-static bool run_one_depth(const PerftPositionSuite& suite, const PerftDepthCase& dc) {
+// cases at least this deep go through the perft TT (shallow ones finish in milliseconds anyway)
+static constexpr int HASHED_MIN_DEPTH = 5;
+
+static bool run_one_depth(const PerftPositionSuite& suite, const PerftDepthCase& dc, int threads, PerftTable* table, bool nodesOnly) {
     Board b;
     b.createBoardFromFEN(suite.fen);
 
@@ -320,7 +268,10 @@ static bool run_one_depth(const PerftPositionSuite& suite, const PerftDepthCase&
               << std::flush;
 
     const auto t0 = std::chrono::high_resolution_clock::now();
-    PerftCounts got = perft(b, dc.depth);
+    PerftTable* caseTable = dc.depth >= HASHED_MIN_DEPTH ? table : nullptr;
+    PerftCounts got;
+    if (nodesOnly) got.nodes = perftNodesParallel(b, dc.depth, threads, caseTable);
+    else           got = perftParallel(b, dc.depth, threads, caseTable);
     const auto t1 = std::chrono::high_resolution_clock::now();
 
     const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
@@ -329,9 +280,11 @@ static bool run_one_depth(const PerftPositionSuite& suite, const PerftDepthCase&
     std::string whyFail;
 
     ok &= check_field("Nodes",  got.nodes,    dc.exp.nodes,    whyFail);
-    ok &= check_field("Caps",   got.captures, dc.exp.captures, whyFail);
-    ok &= check_field("Checks", got.checks,   dc.exp.checks,   whyFail);
-    ok &= check_field("Mates",  got.mates,    dc.exp.mates,    whyFail);
+    if (!nodesOnly) {
+        ok &= check_field("Caps",   got.captures, dc.exp.captures, whyFail);
+        ok &= check_field("Checks", got.checks,   dc.exp.checks,   whyFail);
+        ok &= check_field("Mates",  got.mates,    dc.exp.mates,    whyFail);
+    }
 
     ansi::clear_line();
 
@@ -345,11 +298,13 @@ static bool run_one_depth(const PerftPositionSuite& suite, const PerftDepthCase&
               << "[ " << suite.name << " | depth " << dc.depth << " ] "
               << status
               << ansi::reset
-              << "  (" << fmt_ms(ms) << ")"
-              << "  N:" << got.nodes
-              << " C:" << got.captures
-              << " K:" << got.checks
-              << " M:" << got.mates;
+              << "  (" << fmt_ms(ms) << ", " << (uint64_t)((double)got.nodes * 1000.0 / std::max(ms, 0.001)) << " nps)"
+              << "  N:" << got.nodes;
+    if (!nodesOnly) {
+        std::cout << " C:" << got.captures
+                  << " K:" << got.checks
+                  << " M:" << got.mates;
+    }
 
     if (!hasAnyExpectation) {
         std::cout << "  " << ansi::grey << "(no expected values)" << ansi::reset;
@@ -365,13 +320,210 @@ static bool run_one_depth(const PerftPositionSuite& suite, const PerftDepthCase&
     return ok;
 }
 
-int main() {
+// -----------------------------
+// EPD corpus runner
+// -----------------------------
+//
+// Standard perft EPD lines: "<FEN> ;D1 20 ;D2 400 ;D3 8902 ..." (blank lines and '#' comments skipped).
+// Positions run in parallel (one per worker, nodes-only bulk perft, shared perft TT); within a
+// position the depths run shallow to deep, and a depth is skipped when the time it is predicted
+// to take (last depth's time scaled by the node ratio) would push the position past --skip-ms.
+// That is a forecast, not a limit: a depth that has started (always the first) runs to the end,
+// so a slow position can still take well over it.
+struct EpdCase {
+    int line = 0;
+    std::string fen;
+    std::vector<std::pair<int, uint64_t>> depths;   // (depth, expected nodes), ascending
+};
+
+struct EpdResult {
+    bool failed = false;
+    std::string whyFail;
+    int passedDepths = 0;
+    int skippedDepths = 0;     // forecast to exceed skipMs
+    uint64_t nodes = 0;
+    double ms = 0.0;
+};
+
+static std::string trim(const std::string& s) {
+    const size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) return "";
+    const size_t b = s.find_last_not_of(" \t\r\n");
+    return s.substr(a, b - a + 1);
+}
+
+static bool loadEpd(const std::string& path, std::vector<EpdCase>& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    int lineNo = 0;
+    for (std::string line; std::getline(in, line); ) {
+        ++lineNo;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        EpdCase c;
+        c.line = lineNo;
+
+        std::istringstream fields(line);
+        std::string field;
+        std::getline(fields, field, ';');
+        c.fen = trim(field);
+
+        while (std::getline(fields, field, ';')) {
+            field = trim(field);
+            if (field.size() < 2 || field[0] != 'D') continue;
+            std::istringstream ds(field.substr(1));
+            int depth = 0;
+            uint64_t nodes = 0;
+            if (ds >> depth >> nodes && depth > 0) c.depths.emplace_back(depth, nodes);
+        }
+        std::sort(c.depths.begin(), c.depths.end());
+
+        if (!c.fen.empty() && !c.depths.empty()) out.push_back(std::move(c));
+    }
+    return true;
+}
+
+static EpdResult runEpdCase(const EpdCase& c, double skipMs, PerftTable* table) {
+    EpdResult r;
+    Board b;
+    b.createBoardFromFEN(c.fen);
+
+    double lastMs = 0.0;
+    uint64_t lastNodes = 0;
+
+    for (const auto& [depth, expected] : c.depths) {
+        if (r.failed || (lastNodes > 0 && r.ms + lastMs * (double)expected / (double)lastNodes > skipMs)) {
+            if (!r.failed) r.skippedDepths++;
+            continue;
+        }
+
+        const auto t0 = std::chrono::high_resolution_clock::now();
+        const uint64_t got = perftNodes(b, depth, table);
+        const auto t1 = std::chrono::high_resolution_clock::now();
+
+        lastMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        lastNodes = std::max<uint64_t>(got, 1);
+        r.ms += lastMs;
+        r.nodes += got;
+
+        if (got != expected) {
+            r.failed = true;
+            r.whyFail = "D" + std::to_string(depth) + " (got " + std::to_string(got) + " exp " + std::to_string(expected) + ")";
+        }
+        else {
+            r.passedDepths++;
+        }
+    }
+    return r;
+}
+
+static uint64_t npsOf(uint64_t nodes, double ms) {
+    return (uint64_t)((double)nodes * 1000.0 / std::max(ms, 0.001));
+}
+
+static int runEpd(const std::string& path, int jobs, double skipMs, int hashMB, int slowest) {
+    std::vector<EpdCase> cases;
+    if (!loadEpd(path, cases)) {
+        std::cout << ansi::red << "cannot open " << path << ansi::reset << "\n";
+        return 1;
+    }
+
+    std::unique_ptr<PerftTable> table;
+    if (hashMB > 0) table = std::make_unique<PerftTable>((size_t)hashMB);
+
+    std::cout << ansi::grey
+              << "EPD perft: " << cases.size() << " positions from " << path << " (" << jobs << " jobs, "
+              << "deeper depths skipped past " << skipMs / 1000.0 << " s per position, "
+              << (table ? std::to_string(hashMB) + " MB perft TT" : std::string("no perft TT")) << ")\n"
+              << ansi::reset;
+
+    std::vector<EpdResult> results(cases.size());
+    std::atomic<size_t> next{ 0 };
+    std::mutex outMutex;
+
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> pool;
+    for (int w = 0; w < jobs; ++w) {
+        pool.emplace_back([&] {
+            for (size_t i = next.fetch_add(1); i < cases.size(); i = next.fetch_add(1)) {
+                const EpdCase& c = cases[i];
+                const EpdResult r = runEpdCase(c, skipMs, table.get());
+                results[i] = r;
+
+                std::lock_guard<std::mutex> lock(outMutex);
+                std::cout << (r.failed ? ansi::red : ansi::green)
+                          << "[ line " << c.line << " ] " << (r.failed ? "FAIL" : "PASS") << ansi::reset
+                          << "  (" << fmt_ms(r.ms) << ", " << npsOf(r.nodes, r.ms) << " nps)"
+                          << "  depths " << r.passedDepths << "/" << c.depths.size();
+                if (r.skippedDepths) std::cout << ansi::grey << "  " << r.skippedDepths << " skipped" << ansi::reset;
+                if (r.failed) std::cout << "  " << ansi::red << r.whyFail << "  " << c.fen << ansi::reset;
+                std::cout << "\n";
+            }
+        });
+    }
+    for (std::thread& t : pool) t.join();
+    const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+
+    int failed = 0, partial = 0;
+    uint64_t nodes = 0;
+    for (const EpdResult& r : results) {
+        if (r.failed) failed++;
+        else if (r.skippedDepths) partial++;
+        nodes += r.nodes;
+    }
+
+    std::vector<size_t> order(cases.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return results[a].ms > results[b].ms; });
+
+    std::cout << "\nSlowest positions:\n";
+    for (int k = 0; k < slowest && k < (int)order.size(); ++k) {
+        const size_t i = order[k];
+        std::cout << "  " << fmt_ms(results[i].ms) << "  " << npsOf(results[i].nodes, results[i].ms) << " nps"
+                  << "  line " << cases[i].line << "  " << cases[i].fen << "\n";
+    }
+
+    std::cout << "\nDone. Passed " << (cases.size() - failed) << " / " << cases.size() << " positions"
+              << " (" << partial << " with depths skipped). "
+              << nodes << " nodes in " << fmt_ms(wallMs) << ", " << npsOf(nodes, wallMs) << " nps overall.\n";
+
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
     ansi::enable_virtual_terminal();
 
-    const std::string pos1 = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
-    const std::string pos2 = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
-    const std::string pos3 = "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1";
-    const std::string pos4 = "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1";
+    // PerftSuite [--threads N] [--hash MB] [--nodes-only]
+    // PerftSuite --epd FILE [--threads N] [--hash MB] [--skip-ms N] [--slowest N]
+    // defaults: one thread per hardware thread, 256 MB (--hash 0 disables), full leaf statistics;
+    // --nodes-only checks node totals with the bulk-counting perft.
+    // With --epd the built-in positions are replaced by the file, run one position per thread.
+    int threads = perftDefaultThreads();
+    int hashMB = 256;
+    bool nodesOnly = false;
+    std::string epdPath;
+    double skipMs = 10000.0;   // per-position forecast that skips deeper depths (not a hard limit)
+    int slowest = 10;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--threads" && i + 1 < argc)        threads = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--hash" && i + 1 < argc)      hashMB = std::max(0, std::atoi(argv[++i]));
+        else if (a == "--nodes-only")                nodesOnly = true;
+        else if (a == "--epd" && i + 1 < argc)       epdPath = argv[++i];
+        else if (a == "--skip-ms" && i + 1 < argc)   skipMs = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--slowest" && i + 1 < argc)   slowest = std::max(0, std::atoi(argv[++i]));
+    }
+
+    if (!epdPath.empty()) return runEpd(epdPath, threads, skipMs, hashMB, slowest);
+    std::unique_ptr<PerftTable> table;
+    if (hashMB > 0) table = std::make_unique<PerftTable>((size_t)hashMB);
+
+    const std::string pos1 = PERFT_FENS[0];
+    const std::string pos2 = PERFT_FENS[1];
+    const std::string pos3 = PERFT_FENS[2];
+    const std::string pos4 = PERFT_FENS[3];
 
     std::vector<PerftPositionSuite> suites = {
         {
@@ -427,7 +579,10 @@ int main() {
     int skipped = 0;
 
     std::cout << ansi::grey
-              << "Perft suite: Nodes / Captures / Checks / Mates\n"
+              << "Perft suite: " << (nodesOnly ? "Nodes only, bulk counted" : "Nodes / Captures / Checks / Mates")
+              << " (" << threads << " threads, "
+              << (table ? std::to_string(hashMB) + " MB perft TT from depth " + std::to_string(HASHED_MIN_DEPTH) : std::string("no perft TT"))
+              << ")\n"
               << "Rule: if a depth FAILs for a position, deeper depths for that position are skipped.\n"
               << "On FAIL: prints full perft-divide (Stockfish-like ordering) for that depth.\n"
               << ansi::reset;
@@ -446,7 +601,7 @@ int main() {
             }
 
             total++;
-            bool ok = run_one_depth(suite, dc);
+            bool ok = run_one_depth(suite, dc, threads, table.get(), nodesOnly);
             if (ok) passed++;
             else failedThisPos = true;
         }
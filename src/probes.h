@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Scoped cycle-counting probes. Compiled out unless ENGINE_PROBES is set (CMake option
+// ENGINE_PROBES=ON): ENGINE_PROBE(id) then expands to nothing.
+//
+// Each thread keeps its own accumulators and a stack of open probes. Time is charged
+// exclusively: entering a nested probe stops the clock of the enclosing one, so the
+// shares add up to 100% of probed time (movegen called from evaluate counts as movegen).
+#ifndef ENGINE_PROBES
+#define ENGINE_PROBES 0
+#endif
+
+inline constexpr bool kProbesEnabled = (ENGINE_PROBES != 0);
+
+enum ProbeId {
+    PROBE_SEARCH = 0,
+    PROBE_QUIESCENCE,
+    PROBE_EVALUATE,
+    PROBE_MOVEGEN,
+    PROBE_CHECK_TEST,    // amIInCheck (legality / check detection)
+    PROBE_MAKE_MOVE,
+    PROBE_UNDO_MOVE,
+    PROBE_TT_PROBE,
+    PROBE_TT_STORE,
+    PROBE_COUNT
+};
+
+inline constexpr const char* PROBE_NAMES[PROBE_COUNT] = {
+    "search", "quiescence", "evaluate", "generateAllMoves", "amIInCheck",
+    "makeMove", "undoMove", "probeTT", "storeTT",
+};
+
+struct ProbeTotals {
+    uint64_t ticks[PROBE_COUNT] = {};    // exclusive
+    uint64_t calls[PROBE_COUNT] = {};
+
+    void clear() { *this = ProbeTotals{}; }
+
+    void print(std::ostream& os) const {
+        uint64_t total = 0;
+        for (uint64_t t : ticks) total += t;
+
+        const std::ios_base::fmtflags flags = os.flags();
+        const std::streamsize prec = os.precision();
+        os << std::fixed << std::setprecision(1);
+        os << "time share (exclusive, " << total << " ticks)\n";
+        for (int i = 0; i < PROBE_COUNT; ++i) {
+            if (!calls[i]) continue;
+            os << "  " << std::left << std::setw(18) << PROBE_NAMES[i] << std::right
+               << std::setw(6) << (total ? 100.0 * (double)ticks[i] / (double)total : 0.0) << "%"
+               << std::setw(14) << calls[i] << " calls"
+               << std::setw(10) << (double)ticks[i] / (double)calls[i] << " ticks/call\n";
+        }
+        os.flags(flags);
+        os.precision(prec);
+    }
+};
+
+namespace probes {
+
+inline uint64_t now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+struct ThreadState {
+    static constexpr int kMaxNesting = 1024;
+
+    ProbeTotals totals;
+    uint8_t stack[kMaxNesting];
+    int depth = 0;
+    uint64_t mark = 0;    // when the probe on top of the stack last started being charged
+};
+
+inline ThreadState& state() {
+    static thread_local ThreadState s;
+    return s;
+}
+
+// Totals of the calling thread since the last take(); clears them.
+inline ProbeTotals take() {
+    ThreadState& s = state();
+    const ProbeTotals out = s.totals;
+    s.totals.clear();
+    return out;
+}
+
+class Scope {
+public:
+    explicit Scope(ProbeId id) {
+        ThreadState& s = state();
+        const uint64_t t = now();
+        if (s.depth > 0) s.totals.ticks[s.stack[s.depth - 1]] += t - s.mark;
+        s.totals.calls[id]++;
+        active_ = s.depth < ThreadState::kMaxNesting;
+        if (active_) s.stack[s.depth++] = (uint8_t)id;
+        s.mark = t;
+    }
+
+    ~Scope() {
+        ThreadState& s = state();
+        const uint64_t t = now();
+        if (active_) s.totals.ticks[s.stack[--s.depth]] += t - s.mark;
+        s.mark = t;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    bool active_;
+};
+
+} // namespace probes
+
+#if ENGINE_PROBES
+#define ENGINE_PROBE(id) const probes::Scope engineProbeScope_(id)
+#else
+#define ENGINE_PROBE(id) ((void)0)
+#endif
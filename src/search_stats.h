@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Per-search counters. Collection is compiled out unless ENGINE_SEARCH_STATS is set
+// (CMake option ENGINE_SEARCH_STATS=ON); every increment sits behind `if constexpr`.
+#ifndef ENGINE_SEARCH_STATS
+#define ENGINE_SEARCH_STATS 0
+#endif
+
+inline constexpr bool kSearchStatsEnabled = (ENGINE_SEARCH_STATS != 0);
+
+// Note: there is no eval or pawn hash cache in this engine, so there are no cache hit rates to report.
+struct SearchStats {
+    uint64_t mainNodes = 0;          // search() calls
+    uint64_t qNodes = 0;             // quiescence() calls
+
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;             // key matched
+    uint64_t ttCutoffs = 0;          // returned from the TT bound
+
+    uint64_t betaCutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;   // cutoff on the first move searched (move ordering quality)
+
+    uint64_t nullTries = 0;
+    uint64_t nullCutoffs = 0;
+
+    uint64_t lmrReduced = 0;         // moves searched with a reduction
+    uint64_t lmrResearches = 0;      // reduced moves that beat alpha and were re-searched
+
+    uint64_t aspirationFailHigh = 0;
+    uint64_t aspirationFailLow = 0;
+
+    int selDepth = 0;
+    std::vector<uint64_t> iterationNodes;   // nodes spent in each completed iteration
+
+    void clear() { *this = SearchStats{}; }
+
+    // Effective branching factor of iteration `depth` (1-based) relative to the one before.
+    double ebf(int depth) const {
+        if (depth < 2 || depth > (int)iterationNodes.size() || iterationNodes[depth - 2] == 0) return 0.0;
+        return (double)iterationNodes[depth - 1] / (double)iterationNodes[depth - 2];
+    }
+
+    void print(std::ostream& os) const {
+        auto pct = [](uint64_t a, uint64_t b) { return b ? 100.0 * (double)a / (double)b : 0.0; };
+        const uint64_t nodes = mainNodes + qNodes;
+
+        os << "nodes " << nodes << " (main " << mainNodes << ", q " << qNodes
+           << ", q share " << pct(qNodes, nodes) << "%)\n";
+        os << "tt probes " << ttProbes << ", hit " << pct(ttHits, ttProbes)
+           << "%, cutoff " << pct(ttCutoffs, ttProbes) << "%\n";
+        os << "beta cutoffs " << betaCutoffs << ", first move " << pct(firstMoveCutoffs, betaCutoffs) << "%\n";
+        os << "null move tries " << nullTries << ", success " << pct(nullCutoffs, nullTries) << "%\n";
+        os << "lmr reduced " << lmrReduced << ", re-searched " << pct(lmrResearches, lmrReduced) << "%\n";
+        os << "aspiration fail high " << aspirationFailHigh << ", fail low " << aspirationFailLow << "\n";
+        os << "seldepth " << selDepth << "\n";
+        os << "ebf";
+        for (int d = 2; d <= (int)iterationNodes.size(); ++d) os << " d" << d << "=" << ebf(d);
+        os << "\n";
+    }
+};
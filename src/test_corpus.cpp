@@ -0,0 +1,23 @@
+#include "test_corpus.h"
+
+#include <fstream>
+#include <iostream>
+
+const char* const PERFT_FENS[PERFT_FEN_COUNT] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+};
+
+std::vector<std::string> loadTestCorpus(const std::string& path) {
+    std::vector<std::string> fens(std::begin(PERFT_FENS), std::end(PERFT_FENS));
+
+    std::ifstream in(path);
+    if (!in) std::cerr << "warning: cannot open " << path << ", using the perft FENs only\n";
+    for (std::string line; std::getline(in, line); ) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) fens.push_back(line);
+    }
+    return fens;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Positions shared by the test and benchmark tools (PerftSuite, microbench, board_fuzz).
+
+// The standard perft positions, PerftSuite's "Position 1" to "Position 4": start position,
+// Kiwipete, the rook endgame, and the promotion/castling position.
+inline constexpr int PERFT_FEN_COUNT = 4;
+extern const char* const PERFT_FENS[PERFT_FEN_COUNT];
+
+// PERFT_FENS followed by one FEN per non-empty line of path (usually positions.txt).
+// A missing file is not an error: a warning goes to stderr and only the perft FENs are returned.
+std::vector<std::string> loadTestCorpus(const std::string& path);
@@ -0,0 +1,118 @@
+#include "time_manager.h"
+
+#include <algorithm>
+
+void TimeManager::start(const SearchLimits& limits, int defaultMoveTimeMs, int moveOverheadMs) {
+    start_ = Clock::now();
+    adaptive_ = false;
+
+    lastBest_ = NO_MOVE;
+    lastScore_ = 0;
+    stableIterations_ = 0;
+    bestMoveChanges_ = 0.0;
+    scale_ = 1.0;
+
+    if (limits.moveTimeMs >= 0) {
+        softMs_ = hardMs_ = std::max(1, limits.moveTimeMs - moveOverheadMs);
+        return;
+    }
+
+    if (limits.timeLeftMs < 0) {
+        softMs_ = hardMs_ = std::max(1, defaultMoveTimeMs);
+        return;
+    }
+
+    // Clock mode: spread what is left over the expected number of moves, bank most of the increment
+    adaptive_ = true;
+
+    const int available = std::max(1, limits.timeLeftMs - moveOverheadMs);
+    const int mtg = (limits.movesToGo > 0) ? std::min(limits.movesToGo, 50) : 30;
+
+    int soft = available / mtg + (limits.incrementMs * 3) / 4;
+    int hard = soft * 5;
+
+    // never plan to spend more than a fraction of the clock on one move
+    const int softCap = (mtg == 1) ? (available * 7) / 10 : available / 2;
+    const int hardCap = (available * 8) / 10;
+
+    softMs_ = std::clamp(soft, 1, std::max(1, softCap));
+    hardMs_ = std::clamp(hard, softMs_, std::max(softMs_, hardCap));
+}
+
+void TimeManager::onIteration(int depth, const Move& best, int score) {
+    if (!adaptive_) return;
+
+    const bool changed = (depth > 1) && !(best == lastBest_);
+    const int drop = (depth > 1) ? (lastScore_ - score) : 0;
+
+    lastBest_ = best;
+    lastScore_ = score;
+
+    // recent root changes count more than old ones
+    bestMoveChanges_ = bestMoveChanges_ * 0.5 + (changed ? 1.0 : 0.0);
+    stableIterations_ = changed ? 0 : stableIterations_ + 1;
+
+    // unstable root => think longer; same move for several iterations => stop sooner
+    double stability = 1.0 + 0.7 * bestMoveChanges_;
+    if (stableIterations_ >= 3) stability *= std::max(0.5, 1.0 - 0.1 * (stableIterations_ - 2));
+
+    // falling score => think longer (up to 2x)
+    double trend = 1.0;
+    if (drop > 20) trend = std::min(2.0, 1.0 + drop / 100.0);
+
+    scale_ = std::clamp(stability * trend, 0.4, (double)hardMs_ / (double)softMs_);
+}
+
+bool TimeManager::shouldStop() const {
+    if (!adaptive_) return false;
+    return elapsedMs() >= (int)(softMs_ * scale_);
+}
+
+int TimeManager::elapsedMs() const {
+    return (int)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_).count();
+}
+
+StopTimer::~StopTimer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void StopTimer::arm(TimeManager::Clock::time_point deadline, std::atomic<bool>& flag) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        deadline_ = deadline;
+        flag_ = &flag;
+        armed_ = true;
+        if (!thread_.joinable()) thread_ = std::thread(&StopTimer::run, this);
+    }
+    cv_.notify_all();
+}
+
+void StopTimer::disarm() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        armed_ = false;
+    }
+    cv_.notify_all();
+}
+
+void StopTimer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!quit_) {
+        if (!armed_) {
+            cv_.wait(lock);
+            continue;
+        }
+        // the flag is only touched under the lock, so disarm() never races a late store
+        if (TimeManager::Clock::now() >= deadline_) {
+            flag_->store(true, std::memory_order_relaxed);
+            armed_ = false;
+            continue;
+        }
+        cv_.wait_until(lock, deadline_);
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "chess.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// What the caller knows about the clock for this move. All times in ms; -1 = not given.
+struct SearchLimits {
+    int timeLeftMs  = -1;   // our remaining clock time
+    int incrementMs = 0;    // our increment per move
+    int movesToGo   = 0;    // moves until next time control (0 = sudden death)
+    int moveTimeMs  = -1;   // fixed time for this move (overrides the clock)
+
+    // non-time limits (0 = none)
+    int depth = 0;
+    uint64_t nodes = 0;
+    bool infinite = false;  // search until stop(); never returns on its own
+    bool ponder = false;    // search without a deadline until ponderhit()/stop(); the limits apply from ponderhit
+
+    bool hasClock() const { return timeLeftMs >= 0 || moveTimeMs >= 0; }
+};
+
+// Soft/hard time limits per move.
+// - soft: checked between iterations, scaled by best-move stability and score trend
+// - hard: absolute deadline enforced inside search
+// Without clock information it falls back to a fixed per-move time (soft == hard).
+class TimeManager {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void start(const SearchLimits& limits, int defaultMoveTimeMs, int moveOverheadMs);
+
+    // Restart the clock without touching the budget (ponderhit: our time starts now).
+    void restartClock() { start_ = Clock::now(); }
+
+    // Feed the result of each completed iteration (root best move + score).
+    void onIteration(int depth, const Move& best, int score);
+
+    // True once the (scaled) soft limit has passed; only in clock mode.
+    bool shouldStop() const;
+
+    bool adaptive() const { return adaptive_; }
+    int  softLimitMs() const { return softMs_; }
+    int  hardLimitMs() const { return hardMs_; }
+    int  elapsedMs() const;
+    Clock::time_point hardDeadline() const { return start_ + std::chrono::milliseconds(hardMs_); }
+
+private:
+    Clock::time_point start_{};
+    bool adaptive_ = false;
+    int softMs_ = 0;
+    int hardMs_ = 0;
+
+    // iteration history
+    Move lastBest_ = NO_MOVE;
+    int lastScore_ = 0;
+    int stableIterations_ = 0;
+    double bestMoveChanges_ = 0.0;
+    double scale_ = 1.0;
+};
+
+// Watchdog thread: sets a stop flag at the deadline so search only does a relaxed atomic load.
+// One thread per timer, started on the first arm() and kept until destruction; later searches
+// re-arm it through the condition variable instead of starting a thread each move.
+class StopTimer {
+public:
+    StopTimer() = default;
+    StopTimer(const StopTimer&) = delete;
+    StopTimer& operator=(const StopTimer&) = delete;
+    ~StopTimer();
+
+    void arm(TimeManager::Clock::time_point deadline, std::atomic<bool>& flag);
+    void disarm();   // once this returns the flag is no longer set by this timer
+
+private:
+    void run();
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    TimeManager::Clock::time_point deadline_{};
+    std::atomic<bool>* flag_ = nullptr;
+    bool armed_ = false;
+    bool quit_ = false;
+};
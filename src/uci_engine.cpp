@@ -0,0 +1,367 @@
+#include "bench.h"
+#include "chess.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------
+// Headless UCI front end around Engine (no SFML).
+// ------------------------------------------------------------
+
+static std::string scoreToUCI(int score) {
+    if (std::abs(score) > MATE_THRESHOLD) {
+        const int plies = MATE_SCORE - std::abs(score);
+        const int moves = (plies + 1) / 2;
+        return "mate " + std::to_string(score > 0 ? moves : -moves);
+    }
+    return "cp " + std::to_string(score);
+}
+
+// ------------------------------------------------------------
+// Options: Hash / Threads plus the tunable EngineConfig fields
+// ------------------------------------------------------------
+struct SpinOption {
+    const char* name;
+    int EngineConfig::* field;
+    int minValue;
+    int maxValue;
+};
+
+struct CheckOption {
+    const char* name;
+    bool EngineConfig::* field;
+};
+
+static const SpinOption kSpinOptions[] = {
+    { "Move Overhead",          &EngineConfig::moveOverheadMs,         0,     5000 },
+    { "MultiPV",                &EngineConfig::multiPV,                1,     64 },
+    { "DrawPenalty",            &EngineConfig::drawPenalty,            0,     500 },
+    { "MaxDepth",               &EngineConfig::maxDepth,               1,     100 },
+    { "MaxExtensionsPerLine",   &EngineConfig::maxExtensionsPerLine,   0,     16 },
+    { "AspirationStartWindow",  &EngineConfig::aspirationStartWindow,  10,    1000 },
+    { "AspirationGrowFactor",   &EngineConfig::aspirationGrowFactor,   2,     8 },
+    { "NullMoveReductionBase",  &EngineConfig::nullMoveReductionBase,  1,     6 },
+    { "LmrBase",                &EngineConfig::lmrBase,                0,     300 },
+    { "LmrDivisor",             &EngineConfig::lmrDivisor,             50,    1000 },
+    { "LmrMinDepth",            &EngineConfig::lmrMinDepth,            1,     10 },
+    { "LmrHistoryDivisor",      &EngineConfig::lmrHistoryDivisor,      1000,  100000 },
+    { "SingularMinDepth",       &EngineConfig::singularMinDepth,       2,     20 },
+    { "SingularMarginPerPly",   &EngineConfig::singularMarginPerPly,   0,     20 },
+    { "IirMinDepth",            &EngineConfig::iirMinDepth,            1,     20 },
+    { "IidMinDepth",            &EngineConfig::iidMinDepth,            1,     20 },
+    { "IidReduction",           &EngineConfig::iidReduction,           1,     10 },
+    { "PawnValue",              &EngineConfig::pawnValue,              50,    200 },
+    { "KnightValue",            &EngineConfig::knightValue,            100,   600 },
+    { "BishopValue",            &EngineConfig::bishopValue,            100,   600 },
+    { "RookValue",              &EngineConfig::rookValue,              200,   900 },
+    { "QueenValue",             &EngineConfig::queenValue,             500,   1800 },
+};
+
+static const CheckOption kCheckOptions[] = {
+    { "OwnBook", &EngineConfig::useOpeningBook },
+    { "UseIIR",  &EngineConfig::useIIR },
+    { "UseIID",  &EngineConfig::useIID },
+};
+
+static bool equalsNoCase(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// UCI session
+// ------------------------------------------------------------
+class UciSession {
+public:
+    UciSession() { board_.createBoard(); }
+
+    ~UciSession() {
+        engine_.stop();
+        engine_.wait();
+    }
+
+    void loop() {
+        for (std::string line; std::getline(std::cin, line); ) {
+            std::istringstream iss(line);
+            std::string cmd;
+            iss >> cmd;
+            if (cmd.empty()) continue;
+
+            if (cmd == "quit") break;
+            else if (cmd == "uci")        cmdUci();
+            else if (cmd == "isready")    send("readyok");
+            else if (cmd == "ucinewgame") { finishSearch(); engine_.newGame(); }
+            else if (cmd == "setoption")  cmdSetOption(iss);
+            else if (cmd == "position")   cmdPosition(iss);
+            else if (cmd == "go")         cmdGo(iss);
+            else if (cmd == "stop")       cmdStop();
+            else if (cmd == "ponderhit")  cmdPonderHit();
+            else if (cmd == "d")          board_.printBoard();
+            else if (cmd == "bench")      cmdBench(iss);
+        }
+    }
+
+private:
+    Engine engine_;
+    Board board_;
+    std::mutex outMutex_;
+
+    std::mutex pvMutex_;
+    std::vector<Move> lastPv_;
+
+    // what board_ currently holds: "startpos" or "fen <FEN>", plus the moves played from it
+    std::string positionBase_;
+    std::vector<std::string> positionMoves_;
+
+    void send(const std::string& s) {
+        std::lock_guard<std::mutex> lock(outMutex_);
+        std::cout << s << std::endl;
+    }
+
+    void finishSearch() {
+        engine_.stop();
+        engine_.wait();
+    }
+
+    void cmdBench(std::istringstream& iss) {
+        finishSearch();
+
+        // bench [depth] [counters]
+        int depth = BENCH_DEFAULT_DEPTH;
+        bool counters = false;
+        for (std::string token; iss >> token; ) {
+            if (token == "counters") counters = true;
+            else depth = std::atoi(token.c_str());
+        }
+
+        std::lock_guard<std::mutex> lock(outMutex_);
+        runBench(std::max(1, depth), &std::cout, counters);
+        std::cout.flush();
+    }
+
+    void cmdUci() {
+        const EngineConfig& cfg = engine_.config();
+        std::ostringstream os;
+        os << "id name ChessEngine\n"
+           << "id author Dbliss\n"
+           << "option name Hash type spin default " << cfg.ttSizeMB << " min 1 max 4096\n"
+           << "option name Threads type spin default 1 min 1 max 1\n"
+           << "option name Ponder type check default false\n";
+
+        for (const SpinOption& o : kSpinOptions) {
+            os << "option name " << o.name << " type spin default " << cfg.*o.field
+               << " min " << o.minValue << " max " << o.maxValue << "\n";
+        }
+        for (const CheckOption& o : kCheckOptions) {
+            os << "option name " << o.name << " type check default " << (cfg.*o.field ? "true" : "false") << "\n";
+        }
+        os << "uciok";
+        send(os.str());
+    }
+
+    void cmdSetOption(std::istringstream& iss) {
+        // setoption name <id with spaces> [value <x>]
+        std::string token, name, value;
+        iss >> token;
+        if (token != "name") return;
+
+        while (iss >> token && token != "value") {
+            if (!name.empty()) name += " ";
+            name += token;
+        }
+        std::getline(iss >> std::ws, value);
+
+        finishSearch();
+
+        if (equalsNoCase(name, "Hash")) {
+            const int mb = std::clamp(std::atoi(value.c_str()), 1, 4096);
+            engine_.setHashSize((uint64_t)mb);
+            return;
+        }
+        if (equalsNoCase(name, "Threads")) {
+            // the search is single-threaded; accepted so tournament managers can set it
+            if (std::atoi(value.c_str()) > 1) send("info string search is single-threaded, using 1 thread");
+            return;
+        }
+        if (equalsNoCase(name, "Ponder")) return; // GUI hint only; pondering is driven by "go ponder"
+
+        EngineConfig& cfg = engine_.config();
+        for (const SpinOption& o : kSpinOptions) {
+            if (equalsNoCase(name, o.name)) {
+                // no newGame(): the TT and history survive; the engine rebuilds the LMR table itself
+                cfg.*o.field = std::clamp(std::atoi(value.c_str()), o.minValue, o.maxValue);
+                return;
+            }
+        }
+        for (const CheckOption& o : kCheckOptions) {
+            if (equalsNoCase(name, o.name)) {
+                cfg.*o.field = equalsNoCase(value, "true");
+                return;
+            }
+        }
+        send("info string unknown option " + name);
+    }
+
+    void cmdPosition(std::istringstream& iss) {
+        finishSearch();
+
+        std::string sub, token, fen;
+        iss >> sub;
+
+        if (sub == "startpos") {
+            iss >> token;
+        }
+        else if (sub == "fen") {
+            while (iss >> token && token != "moves") fen += token + " ";
+            if (!fen.empty()) fen.pop_back();
+        }
+        else {
+            return;
+        }
+        const std::string base = (sub == "fen") ? "fen " + fen : sub;
+
+        std::vector<std::string> moves;
+        if (token == "moves") {
+            for (std::string mv; iss >> mv; ) moves.push_back(mv);
+        }
+
+        // GUIs resend the whole game every move: if it extends what board_ already holds, play only the new suffix
+        size_t first = 0;
+        if (base == positionBase_ && moves.size() >= positionMoves_.size() &&
+            std::equal(positionMoves_.begin(), positionMoves_.end(), moves.begin())) {
+            first = positionMoves_.size();
+        }
+        else {
+            if (sub == "fen") board_.createBoardFromFEN(fen);
+            else              board_.createBoard();
+            positionBase_ = base;
+            positionMoves_.clear();
+        }
+
+        for (size_t i = first; i < moves.size(); ++i) {
+            Move mv;
+            if (!parseUCIMove(board_, moves[i], mv)) {
+                send("info string illegal move " + moves[i]);
+                break;
+            }
+            Undo u;
+            board_.makeMove(mv, u);
+            positionMoves_.push_back(moves[i]);
+        }
+    }
+
+    void cmdGo(std::istringstream& iss) {
+        finishSearch();
+
+        SearchLimits limits;
+        bool ponder = false;
+        int wtime = -1, btime = -1, winc = 0, binc = 0;
+
+        std::string token;
+        while (iss >> token) {
+            if      (token == "wtime")     iss >> wtime;
+            else if (token == "btime")     iss >> btime;
+            else if (token == "winc")      iss >> winc;
+            else if (token == "binc")      iss >> binc;
+            else if (token == "movestogo") iss >> limits.movesToGo;
+            else if (token == "depth")     iss >> limits.depth;
+            else if (token == "nodes")     iss >> limits.nodes;
+            else if (token == "movetime")  iss >> limits.moveTimeMs;
+            else if (token == "infinite")  limits.infinite = true;
+            else if (token == "ponder")    ponder = true;
+        }
+
+        limits.timeLeftMs  = board_.whiteToMove ? wtime : btime;
+        limits.incrementMs = board_.whiteToMove ? winc : binc;
+
+        // no limits at all means "think until told to stop"
+        if (!limits.hasClock() && limits.depth <= 0 && limits.nodes == 0) limits.infinite = true;
+
+        // go ponder: search the position after the expected reply; the clock limits apply from ponderhit
+        limits.ponder = ponder;
+
+        launch(limits);
+    }
+
+    void cmdStop() {
+        // a stopped ponder search (ponder miss) still owes the GUI a bestmove, which the callback sends
+        engine_.stop();
+        engine_.wait();
+    }
+
+    void cmdPonderHit() {
+        // converts in place: everything searched while pondering is kept
+        engine_.ponderhit();
+    }
+
+    void launch(const SearchLimits& limits) {
+        {
+            std::lock_guard<std::mutex> lock(pvMutex_);
+            lastPv_.clear();
+        }
+
+        auto onInfo = [this](const SearchInfo& info) {
+            if (info.multiPV == 1) {
+                std::lock_guard<std::mutex> lock(pvMutex_);
+                lastPv_ = info.pv;
+            }
+
+            std::ostringstream os;
+            os << "info depth " << info.depth
+               << " seldepth " << info.seldepth
+               << " multipv " << info.multiPV
+               << " score " << scoreToUCI(info.score)
+               << " nodes " << info.nodes
+               << " nps " << info.nps
+               << " hashfull " << info.hashfull
+               << " time " << info.timeMs;
+            if (!info.pv.empty()) {
+                os << " pv";
+                for (const Move& m : info.pv) os << " " << moveToUCI(m);
+            }
+            send(os.str());
+        };
+
+        auto onBestMove = [this](const Move& best) {
+            std::string line = "bestmove " + moveToUCI(best);
+            {
+                std::lock_guard<std::mutex> lock(pvMutex_);
+                if (lastPv_.size() >= 2 && lastPv_[0] == best) line += " ponder " + moveToUCI(lastPv_[1]);
+            }
+            send(line);
+        };
+
+        engine_.startSearch(board_, limits, onInfo, onBestMove);
+    }
+};
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    // "uci_engine bench [depth] [counters]": run the benchmark and exit (for scripts / CI)
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        int depth = BENCH_DEFAULT_DEPTH;
+        bool counters = false;
+        for (int i = 2; i < argc; ++i) {
+            if (std::string(argv[i]) == "counters") counters = true;
+            else depth = std::max(1, std::atoi(argv[i]));
+        }
+        runBench(depth, &std::cout, counters);
+        return 0;
+    }
+
+    UciSession session;
+    session.loop();
+    return 0;
+}
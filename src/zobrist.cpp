@@ -35,7 +35,7 @@ std::vector<uint64_t> generateRandomNumbers(size_t count, uint64_t seed)
 }
 
 
-void initializeZobristTable() {
+static void fillZobristTable() {
     // Generate random numbers
     const size_t totalNumbers = 64 * 12 + 1 + 6 + 8;  // all pieces + moves , whitetomove, castling, en passant column
     auto randomNumbers = generateRandomNumbers(totalNumbers, 5259408);
@@ -59,4 +59,10 @@ void initializeZobristTable() {
 
     zobristSideToMove = randomNumbers[j];
     j += 1;
+}
+
+// Fixed seed, so the keys never change; every Board() calls this, only the first call does work.
+void initializeZobristTable() {
+    static const bool done = (fillZobristTable(), true);
+    (void)done;
 }
\ No newline at end of file